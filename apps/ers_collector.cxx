@@ -0,0 +1,380 @@
+/*
+ *  ers_collector.cxx
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <ers/ers.hpp>
+#include <ers/InputStream.hpp>
+
+/** \file ers_collector.cxx
+  * Receives issues from several ERS input streams, merges them in time order, suppresses duplicates
+  * and reports them to the ERS streams configured for this application.
+  */
+
+ERS_DECLARE_ISSUE( ers_collector,
+		   DuplicatesSuppressed,
+		   count << " duplicate(s) of the following issue have been suppressed",
+		   ((size_t)count ) )
+
+namespace
+{
+    using steady_clock = std::chrono::steady_clock;
+    using system_clock = std::chrono::system_clock;
+    const std::chrono::seconds IdleTimeout( 1 );
+
+    struct Options
+    {
+	std::chrono::milliseconds	m_window{ 500 };
+	std::chrono::milliseconds	m_dedup_interval{ 1000 };
+	size_t				m_max_pending = 100000;
+    };
+
+    struct Statistics
+    {
+	std::atomic<uint64_t>	m_received{ 0 };
+	std::atomic<uint64_t>	m_reported{ 0 };
+	std::atomic<uint64_t>	m_duplicates{ 0 };
+	std::atomic<uint64_t>	m_late{ 0 };
+    };
+
+    void report( const ers::Issue & issue )
+    {
+	if ( issue.severity() == ers::Debug )
+	    ers::StreamManager::instance().debug( issue, issue.severity().rank );
+	else
+	    ers::StreamManager::instance().report_issue( issue.severity(), issue );
+    }
+
+    /** Merges issues of a subset of sources. Issues are kept for the duration of the reorder window
+      * and are reported in the order of their time stamps by a dedicated thread.
+      */
+    class Partition
+    {
+      public:
+	Partition( const Options & options, Statistics & statistics )
+	  : m_options( options ),
+	    m_statistics( statistics ),
+	    m_sequence( 0 ),
+	    m_terminated( false ),
+	    m_thread( &Partition::run, this )
+	{ ; }
+
+	~Partition()
+	{
+	    {
+		std::scoped_lock lock( m_mutex );
+		m_terminated = true;
+	    }
+	    m_condition.notify_one();
+	    m_thread.join();
+	}
+
+	void push( std::unique_ptr<ers::Issue> issue )
+	{
+	    ++m_statistics.m_received;
+	    std::scoped_lock lock( m_mutex );
+	    m_inbox.push_back( Entry{ issue->ptime(), steady_clock::now(), m_sequence++, std::move( issue ) } );
+	    if ( m_inbox.size() == 1 )
+		m_condition.notify_one();
+	}
+
+      private:
+	struct Entry
+	{
+	    system_clock::time_point		m_time;
+	    steady_clock::time_point		m_arrival;
+	    uint64_t				m_sequence;
+	    std::unique_ptr<ers::Issue>		m_issue;
+
+	    // the heap keeps the earliest issue on top
+	    bool operator<( const Entry & other ) const
+	    { return m_time != other.m_time ? m_time > other.m_time : m_sequence > other.m_sequence; }
+	};
+
+	struct Duplicate
+	{
+	    steady_clock::time_point	m_since;
+	    size_t			m_count;
+	    std::unique_ptr<ers::Issue>	m_last;
+	};
+
+	void run()
+	{
+	    std::vector<Entry> inbox;
+	    std::unique_lock lock( m_mutex );
+	    while ( true )
+	    {
+		auto deadline = m_heap.empty()
+			? steady_clock::now() + IdleTimeout
+			: m_heap.front().m_arrival + m_options.m_window;
+		m_condition.wait_until( lock, deadline, [this]() { return !m_inbox.empty() || m_terminated; } );
+
+		bool terminated = m_terminated;
+		inbox.swap( m_inbox );
+		lock.unlock();
+
+		for ( Entry & e : inbox )
+		{
+		    m_heap.push_back( std::move( e ) );
+		    std::push_heap( m_heap.begin(), m_heap.end() );
+		}
+		inbox.clear();
+
+		release( terminated );
+		expire_duplicates( terminated );
+
+		if ( terminated )
+		    break;
+		lock.lock();
+	    }
+	}
+
+	void release( bool all )
+	{
+	    auto now = steady_clock::now();
+	    auto system_now = system_clock::now();
+	    while ( !m_heap.empty() )
+	    {
+		const Entry & top = m_heap.front();
+		if (    !all
+		     && m_heap.size() <= m_options.m_max_pending
+		     && top.m_arrival + m_options.m_window > now
+		     && top.m_time + m_options.m_window > system_now )
+		{
+		    break;
+		}
+
+		std::pop_heap( m_heap.begin(), m_heap.end() );
+		Entry e = std::move( m_heap.back() );
+		m_heap.pop_back();
+
+		if ( e.m_time < m_last_time )
+		    ++m_statistics.m_late;
+		else
+		    m_last_time = e.m_time;
+
+		deduplicate( std::move( e.m_issue ), now );
+	    }
+	}
+
+	void deduplicate( std::unique_ptr<ers::Issue> issue, steady_clock::time_point now )
+	{
+	    if ( !m_options.m_dedup_interval.count() )
+	    {
+		report( *issue );
+		++m_statistics.m_reported;
+		return;
+	    }
+
+	    const ers::Context & c = issue->context();
+	    size_t key = std::hash<std::string>()( issue->message() );
+	    for ( const char * s : { issue->get_class_name(), c.file_name(), c.host_name(), c.application_name() } )
+		key = key * 31 + std::hash<std::string>()( s );
+	    key = key * 31 + c.line_number();
+
+	    auto it = m_duplicates.find( key );
+	    if ( it != m_duplicates.end() && now - it->second.m_since < m_options.m_dedup_interval )
+	    {
+		++it->second.m_count;
+		it->second.m_last = std::move( issue );
+		++m_statistics.m_duplicates;
+		return;
+	    }
+
+	    if ( it != m_duplicates.end() )
+	    {
+		summarize( it->second );
+		m_duplicates.erase( it );
+	    }
+
+	    report( *issue );
+	    ++m_statistics.m_reported;
+	    m_duplicates.emplace( key, Duplicate{ now, 0, std::unique_ptr<ers::Issue>() } );
+	}
+
+	void expire_duplicates( bool all )
+	{
+	    auto now = steady_clock::now();
+	    for ( auto it = m_duplicates.begin(); it != m_duplicates.end(); )
+	    {
+		if ( all || now - it->second.m_since >= m_options.m_dedup_interval )
+		{
+		    summarize( it->second );
+		    it = m_duplicates.erase( it );
+		}
+		else
+		{
+		    ++it;
+		}
+	    }
+	}
+
+	void summarize( const Duplicate & d )
+	{
+	    if ( d.m_count )
+	    {
+		ers_collector::DuplicatesSuppressed issue( ERS_HERE, d.m_count, *d.m_last );
+		issue.set_severity( d.m_last->severity() );
+		report( issue );
+	    }
+	}
+
+	const Options &				m_options;
+	Statistics &				m_statistics;
+
+	std::mutex				m_mutex;
+	std::condition_variable			m_condition;
+	std::vector<Entry>			m_inbox;
+	uint64_t				m_sequence;
+	bool					m_terminated;
+
+	// used by the partition thread only
+	std::vector<Entry>			m_heap;
+	system_clock::time_point		m_last_time;
+	std::unordered_map<size_t, Duplicate>	m_duplicates;
+
+	std::thread				m_thread;
+    };
+
+    struct Source : public ers::IssueReceiver
+    {
+	explicit Source( Partition & partition )
+	  : m_partition( partition )
+	{ ; }
+
+	void receive( const ers::Issue & issue ) override
+	{
+	    m_partition.push( std::unique_ptr<ers::Issue>( issue.clone() ) );
+	}
+
+	Partition & m_partition;
+    };
+}
+
+void print_description()
+{
+    std::cout << "Description:" << std::endl;
+    std::cout << "\tReceives issues from the given ERS input streams, merges them in time order, suppresses" << std::endl;
+    std::cout << "\tduplicates and reports them to the ERS streams configured for this application." << std::endl;
+    std::cout << "\tThe application runs until it gets SIGINT or SIGTERM." << std::endl;
+}
+
+void print_usage()
+{
+    std::cout << "Usage: ers_collector [-h]|[--help] [-w window] [-d interval] [-j threads] -s stream:parameters ..." << std::endl;
+    std::cout << "Options/Arguments:" << std::endl;
+    std::cout << "\t[-h]|[--help]\tprints this help screen." << std::endl;
+    std::cout << "\t-s stream:parameters\tinput stream to read issues from, e.g. shm:node-logs or protofile:/tmp/errors.pb" << std::endl;
+    std::cout << "\t-w window\treorder window in milliseconds, default is 500." << std::endl;
+    std::cout << "\t-d interval\tduplicates suppression interval in milliseconds, 0 disables suppression, default is 1000." << std::endl;
+    std::cout << "\t-j threads\tnumber of threads which process the input streams, default is one per stream up to the number of cores." << std::endl;
+}
+
+int main( int argc, char** argv )
+{
+    Options options;
+    size_t threads = 0;
+    std::vector<std::string> streams;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+	if ( !strcmp( argv[i], "--help" ) || !strcmp( argv[i], "-h" ) )
+	{
+	    print_description();
+	    print_usage();
+	    return 0;
+	}
+	else if ( !strcmp( argv[i], "-s" ) && i + 1 < argc )
+	{
+	    streams.push_back( argv[++i] );
+	}
+	else if ( !strcmp( argv[i], "-w" ) && i + 1 < argc )
+	{
+	    options.m_window = std::chrono::milliseconds( atol( argv[++i] ) );
+	}
+	else if ( !strcmp( argv[i], "-d" ) && i + 1 < argc )
+	{
+	    options.m_dedup_interval = std::chrono::milliseconds( atol( argv[++i] ) );
+	}
+	else if ( !strcmp( argv[i], "-j" ) && i + 1 < argc )
+	{
+	    threads = atol( argv[++i] );
+	}
+	else
+	{
+	    print_usage();
+	    return 1;
+	}
+    }
+
+    if ( streams.empty() )
+    {
+	print_usage();
+	return 1;
+    }
+
+    // the signals are handled by the main thread, so they must be blocked before any other thread is started
+    sigset_t signals;
+    sigemptyset( &signals );
+    sigaddset( &signals, SIGINT );
+    sigaddset( &signals, SIGTERM );
+    pthread_sigmask( SIG_BLOCK, &signals, 0 );
+
+    if ( !threads )
+	threads = std::min<size_t>( streams.size(), std::max( 1u, std::thread::hardware_concurrency() ) );
+
+    Statistics statistics;
+    std::vector<std::unique_ptr<Partition> > partitions;
+    for ( size_t i = 0; i < threads; ++i )
+	partitions.emplace_back( new Partition( options, statistics ) );
+
+    std::vector<std::unique_ptr<Source> > sources;
+    for ( size_t i = 0; i < streams.size(); ++i )
+    {
+	std::string::size_type pos = streams[i].find( ':' );
+	std::string name = streams[i].substr( 0, pos );
+	std::string parameters = pos == std::string::npos ? "" : streams[i].substr( pos + 1 );
+
+	sources.emplace_back( new Source( *partitions[i % partitions.size()] ) );
+	try
+	{
+	    ers::StreamManager::instance().add_receiver( name, { parameters }, sources.back().get() );
+	}
+	catch ( ers::Issue & ex )
+	{
+	    ers::fatal( ex );
+	    return 1;
+	}
+    }
+
+    int signal;
+    sigwait( &signals, &signal );
+
+    for ( auto & s : sources )
+	ers::StreamManager::instance().remove_receiver( s.get() );
+    partitions.clear();
+
+    std::cerr << "ers_collector: received " << statistics.m_received
+	      << ", reported " << statistics.m_reported
+	      << ", suppressed duplicates " << statistics.m_duplicates
+	      << ", out of order " << statistics.m_late << std::endl;
+
+    return 0;
+}
@@ -6,45 +6,372 @@
  *
  */
 
-#include <ers/ers.hpp>
+#include <stdlib.h>
 #include <string.h>
 
-/** \file config.cxx 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <ers/ers.hpp>
+
+/** \file config.cxx
   * Prints current configuration of all ERS streams,
-  * taking into account environment variables. 
+  * taking into account environment variables.
+  * In the benchmark mode measures the cost of reporting issues via the configured streams.
   */
 
+ERS_DECLARE_ISSUE( ers_config,
+		   BenchmarkIssue,
+		   "Benchmark issue",
+		   ERS_EMPTY )
+
+ERS_DECLARE_ISSUE( ers_config,
+		   BenchmarkParametersIssue,
+		   "Benchmark issue " << index << " from \"" << source << "\" has value " << value,
+		   ((int)index )
+		   ((std::string)source )
+		   ((double)value ) )
+
+extern "C"
+{
+    void * __libc_malloc( size_t size );
+    void * __libc_calloc( size_t n, size_t size );
+    void * __libc_realloc( void * p, size_t size );
+    void __libc_free( void * p );
+}
+
+namespace
+{
+    // Allocations made by the current thread, counted by the malloc family functions defined below,
+    // which replace the ones of the C library, so the allocations made by C code are counted as well
+    thread_local uint64_t allocations = 0;
+}
+
+extern "C"
+{
+    void * malloc( size_t size )
+    {
+	++allocations;
+	return __libc_malloc( size );
+    }
+
+    void * calloc( size_t n, size_t size )
+    {
+	++allocations;
+	return __libc_calloc( n, size );
+    }
+
+    void * realloc( void * p, size_t size )
+    {
+	++allocations;
+	return __libc_realloc( p, size );
+    }
+
+    void free( void * p )
+    {
+	__libc_free( p );
+    }
+}
+
+namespace
+{
+    using steady_clock = std::chrono::steady_clock;
+
+    /** Latency histogram with 16 buckets per power of two, which gives about 6% precision */
+    class Histogram
+    {
+      public:
+	Histogram()
+	  : m_counts( Buckets, 0 )
+	{ ; }
+
+	void add( uint64_t value )
+	{
+	    ++m_counts[index( value )];
+	}
+
+	void add( const Histogram & h )
+	{
+	    for ( size_t i = 0; i < Buckets; ++i )
+		m_counts[i] += h.m_counts[i];
+	}
+
+	uint64_t percentile( double p ) const
+	{
+	    uint64_t total = 0;
+	    for ( uint64_t c : m_counts )
+		total += c;
+
+	    uint64_t rank = (uint64_t)( p * total );
+	    uint64_t sum = 0;
+	    for ( size_t i = 0; i < Buckets; ++i )
+	    {
+		sum += m_counts[i];
+		if ( sum > rank )
+		    return value( i );
+	    }
+	    return 0;
+	}
+
+      private:
+	static const size_t Buckets = 1024;
+
+	static size_t index( uint64_t v )
+	{
+	    if ( v < 16 )
+		return v;
+	    int e = 63 - __builtin_clzll( v );
+	    return ( e - 3 ) * 16 + ( ( v >> ( e - 4 ) ) & 15 );
+	}
+
+	static uint64_t value( size_t i )
+	{
+	    if ( i < 16 )
+		return i;
+	    int e = i / 16 + 3;
+	    return ( 16 + i % 16 ) << ( e - 4 );
+	}
+
+	std::vector<uint64_t>	m_counts;
+    };
+
+    struct Result
+    {
+	Histogram	m_latency;
+	uint64_t	m_issues = 0;
+	uint64_t	m_allocations = 0;
+	uint64_t	m_exceptions = 0;
+	double		m_seconds = 0;		/**< \brief actual duration, the threads may overrun the deadline */
+    };
+
+    std::unique_ptr<ers::Issue>
+    make_issue( const std::string & type )
+    {
+	if ( type == "simple" )
+	    return std::make_unique<ers_config::BenchmarkIssue>( ERS_HERE );
+
+	if ( type == "params" )
+	    return std::make_unique<ers_config::BenchmarkParametersIssue>( ERS_HERE, 42, "ers_config", 3.14 );
+
+	if ( type == "chained" )
+	{
+	    ers_config::BenchmarkParametersIssue cause( ERS_HERE, 42, "ers_config", 3.14 );
+	    return std::make_unique<ers_config::BenchmarkIssue>( ERS_HERE, cause );
+	}
+
+	return std::unique_ptr<ers::Issue>();
+    }
+
+    void
+    run( ers::severity severity, const std::string & type, const steady_clock::time_point & deadline, Result & result )
+    {
+	std::unique_ptr<ers::Issue> issue = make_issue( type );
+	ers::StreamManager & manager = ers::StreamManager::instance();
+
+	while ( steady_clock::now() < deadline )
+	{
+	    for ( int i = 0; i < 64; ++i )
+	    {
+		uint64_t a = allocations;
+		steady_clock::time_point start = steady_clock::now();
+		try
+		{
+		    manager.report_issue( severity, *issue );
+		}
+		catch ( ers::Issue & ex )
+		{
+		    // the "throw" stream is configured
+		    ++result.m_exceptions;
+		}
+		steady_clock::time_point end = steady_clock::now();
+		result.m_allocations += allocations - a;
+		result.m_latency.add( std::chrono::duration_cast<std::chrono::nanoseconds>( end - start ).count() );
+	    }
+	    result.m_issues += 64;
+	}
+    }
+
+    Result
+    benchmark( ers::severity severity, const std::string & type, unsigned int threads, double seconds )
+    {
+	// the streams are created before the measurement starts
+	ers::initialize();
+
+	std::vector<Result> results( threads );
+	std::vector<std::thread> workers;
+	steady_clock::time_point start = steady_clock::now();
+	steady_clock::time_point deadline = start
+		+ std::chrono::duration_cast<steady_clock::duration>( std::chrono::duration<double>( seconds ) );
+	for ( unsigned int i = 0; i < threads; ++i )
+	{
+	    workers.emplace_back( run, severity, std::cref( type ), deadline, std::ref( results[i] ) );
+	}
+
+	Result total;
+	for ( unsigned int i = 0; i < threads; ++i )
+	{
+	    workers[i].join();
+	    total.m_latency.add( results[i].m_latency );
+	    total.m_issues += results[i].m_issues;
+	    total.m_allocations += results[i].m_allocations;
+	    total.m_exceptions += results[i].m_exceptions;
+	}
+	total.m_seconds = std::chrono::duration<double>( steady_clock::now() - start ).count();
+	return total;
+    }
+}
+
 void print_description()
 {
     std::cout << "Description:" << std::endl;
     std::cout << "\tPrints ERS streams configuration in the current shell." << std::endl;
+    std::cout << "\tIn the benchmark mode reports synthetic issues via the configured streams of every severity" << std::endl;
+    std::cout << "\tand prints throughput, latency percentiles and heap allocations per issue." << std::endl;
 }
 
 void print_usage()
 {
-    std::cout << "Usage: ers_pc [-h]|[--help]" << std::endl;
+    std::cout << "Usage: ers_config [-h]|[--help]" << std::endl;
+    std::cout << "       ers_config --bench [--threads N] [--seconds S] [--issue-type T] [--severity V] [-o file]" << std::endl;
     std::cout << "Options/Arguments:" << std::endl;
-    std::cout << "\t[-h]|[--help]\tprints this help screen." << std::endl;
+    std::cout << "\t[-h]|[--help]\t\tprints this help screen." << std::endl;
+    std::cout << "\t--bench\t\t\tmeasures the cost of reporting issues via the configured streams." << std::endl;
+    std::cout << "\t--threads N\t\tnumber of reporting threads, default is 1." << std::endl;
+    std::cout << "\t--seconds S\t\tduration of the measurement for every severity, default is 1." << std::endl;
+    std::cout << "\t--issue-type T\t\tone of \"simple\", \"params\" or \"chained\", default is \"simple\"." << std::endl;
+    std::cout << "\t--severity V\t\tmeasures only the given severity, e.g. \"ERROR\"." << std::endl;
+    std::cout << "\t-o file\t\t\twrites the results to the file instead of the standard output," << std::endl;
+    std::cout << "\t\t\t\twhich may be used by the configured streams." << std::endl;
 }
 
 int main( int argc, char** argv )
 {
-    if ( argc > 1 )
+    if ( argc == 1 )
     {
-    	if ( 	 !strcmp( argv[1], "--help" )
-              || !strcmp( argv[1], "-h" ) )
-        {
-            print_description();
-        }
-        else
-        {
-            print_usage();
-        }
+	std::cout << ers::StreamManager::instance();
+	return 0;
     }
-    else
+
+    bool bench = false;
+    unsigned int threads = 1;
+    double seconds = 1.;
+    std::string type( "simple" );
+    std::string output;
+    std::vector<ers::severity> severities;
+
+    for ( int i = 1; i < argc; ++i )
     {
-	std::cout << ers::StreamManager::instance();
+	if ( !strcmp( argv[i], "--help" ) || !strcmp( argv[i], "-h" ) )
+	{
+	    print_description();
+	    print_usage();
+	    return 0;
+	}
+	else if ( !strcmp( argv[i], "--bench" ) )
+	{
+	    bench = true;
+	}
+	else if ( !strcmp( argv[i], "--threads" ) && i + 1 < argc )
+	{
+	    threads = std::max( 1, atoi( argv[++i] ) );
+	}
+	else if ( !strcmp( argv[i], "--seconds" ) && i + 1 < argc )
+	{
+	    seconds = atof( argv[++i] );
+	}
+	else if ( !strcmp( argv[i], "--issue-type" ) && i + 1 < argc )
+	{
+	    type = argv[++i];
+	}
+	else if ( !strcmp( argv[i], "--severity" ) && i + 1 < argc )
+	{
+	    ers::severity s;
+	    try
+	    {
+		ers::parse( argv[++i], s );
+	    }
+	    catch ( ers::Issue & ex )
+	    {
+		std::cerr << "Unknown severity \"" << argv[i] << "\"" << std::endl;
+		return 1;
+	    }
+	    severities.push_back( s );
+	}
+	else if ( !strcmp( argv[i], "-o" ) && i + 1 < argc )
+	{
+	    output = argv[++i];
+	}
+	else
+	{
+	    print_usage();
+	    return 1;
+	}
+    }
+
+    if ( !bench )
+    {
+	print_usage();
+	return 1;
+    }
+
+    if ( !make_issue( type ) )
+    {
+	std::cerr << "Unknown issue type \"" << type << "\"" << std::endl;
+	return 1;
+    }
+
+    if ( severities.empty() )
+    {
+	for ( short s = ers::Debug; s <= ers::Fatal; ++s )
+	    severities.push_back( (ers::severity)s );
     }
-    return 0; 
-}
 
+    std::vector<Result> results;
+    for ( ers::severity s : severities )
+    {
+	results.push_back( benchmark( s, type, threads, seconds ) );
+    }
+
+    std::ofstream file;
+    if ( !output.empty() )
+    {
+	file.open( output );
+	if ( !file )
+	{
+	    std::cerr << "Can not open \"" << output << "\" file" << std::endl;
+	    return 1;
+	}
+    }
+    std::ostream & out = output.empty() ? std::cout : file;
+
+    out << std::endl << ers::StreamManager::instance();
+    out << "threads = " << threads << " issue type = " << type << std::endl << std::endl;
+    out << std::left << std::setw( 12 ) << "severity" << std::right
+	<< std::setw( 14 ) << "issues/s"
+	<< std::setw( 12 ) << "p50 (ns)"
+	<< std::setw( 12 ) << "p99 (ns)"
+	<< std::setw( 12 ) << "p999 (ns)"
+	<< std::setw( 16 ) << "allocs/issue" << std::endl;
+    for ( size_t i = 0; i < severities.size(); ++i )
+    {
+	const Result & r = results[i];
+	out << std::left << std::setw( 12 ) << ers::to_string( severities[i] ) << std::right
+	    << std::setw( 14 ) << (uint64_t)( r.m_seconds > 0 ? r.m_issues / r.m_seconds : 0 )
+	    << std::setw( 12 ) << r.m_latency.percentile( 0.5 )
+	    << std::setw( 12 ) << r.m_latency.percentile( 0.99 )
+	    << std::setw( 12 ) << r.m_latency.percentile( 0.999 )
+	    << std::setw( 16 ) << std::fixed << std::setprecision( 2 )
+	    << ( r.m_issues ? (double)r.m_allocations / r.m_issues : 0. ) << std::endl;
+	if ( r.m_exceptions )
+	{
+	    out << "\t" << r.m_exceptions << " issues have been thrown by the stream" << std::endl;
+	}
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+/*
+ *  ers_ringdump.cxx
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <ers/ers.hpp>
+#include <ers/StandardStreamOutput.hpp>
+#include <ers/internal/MMapRing.hpp>
+
+/** \file ers_ringdump.cxx
+  * Prints issues stored in the ring buffer files produced by the "mmapring" ERS stream.
+  */
+
+void print_description()
+{
+    std::cout << "Description:" << std::endl;
+    std::cout << "\tPrints issues stored in the ERS ring buffer files ordered by their time." << std::endl;
+}
+
+void print_usage()
+{
+    std::cout << "Usage: ers_ringdump [-h]|[--help] [-v verbosity] [-n last] file [file ...]" << std::endl;
+    std::cout << "Options/Arguments:" << std::endl;
+    std::cout << "\t[-h]|[--help]\tprints this help screen." << std::endl;
+    std::cout << "\t-v verbosity\tERS verbosity level used for printing issues, default is 0." << std::endl;
+    std::cout << "\t-n last\t\tprints only the given number of the most recent issues." << std::endl;
+}
+
+int main( int argc, char** argv )
+{
+    int verbosity = 0;
+    size_t last = 0;
+    std::vector<std::string> files;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+	if ( !strcmp( argv[i], "--help" ) || !strcmp( argv[i], "-h" ) )
+	{
+	    print_description();
+	    print_usage();
+	    return 0;
+	}
+	else if ( !strcmp( argv[i], "-v" ) && i + 1 < argc )
+	{
+	    verbosity = atoi( argv[++i] );
+	}
+	else if ( !strcmp( argv[i], "-n" ) && i + 1 < argc )
+	{
+	    last = atol( argv[++i] );
+	}
+	else
+	{
+	    files.push_back( argv[i] );
+	}
+    }
+
+    if ( files.empty() )
+    {
+	print_usage();
+	return 1;
+    }
+
+    std::vector<std::unique_ptr<ers::Issue> > issues;
+    for ( size_t i = 0; i < files.size(); ++i )
+    {
+	try
+	{
+	    ers::MMapRing ring( files[i] );
+	    ring.for_each( [&issues]( uint64_t, const ers::BinaryRecord & record ) {
+		issues.emplace_back( record.to_issue() );
+	    } );
+	}
+	catch ( ers::Issue & ex )
+	{
+	    ers::error( ex );
+	}
+    }
+
+    std::stable_sort( issues.begin(), issues.end(),
+	[]( const std::unique_ptr<ers::Issue> & a, const std::unique_ptr<ers::Issue> & b ) {
+	    return a->ptime() < b->ptime();
+	} );
+
+    size_t first = last && last < issues.size() ? issues.size() - last : 0;
+    for ( size_t i = first; i < issues.size(); ++i )
+    {
+	ers::StandardStreamOutput::println( std::cout, *issues[i], verbosity );
+    }
+
+    return 0;
+}
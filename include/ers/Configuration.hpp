@@ -15,17 +15,26 @@
   * \brief ers header and documentation file
   */
 
+#include <stdint.h>
+
+#include <atomic>
 #include <iostream>
+#include <shared_mutex>
+#include <string>
+#include <vector>
 
 namespace ers
 {   
+    class Context;
     class Issue;
     template <class > class SingletonCreator;
     
     /** The \c Configuration class provides API for configuring ERS output streams.
+      * The debug level can be changed at any time. Besides the global debug level, which is used by default,
+      * different levels can be set for the issues reported by particular packages, source files or functions.
       * 
       * \author Serguei Kolos
-      * \version 1.2
+      * \version 1.3
       * \brief Manager of ERS streams configuration. 
       * \see ers::debug
       * \see ers::error
@@ -45,21 +54,85 @@ namespace ers
   	static Configuration & instance();	/**< \brief return the singleton */
         
         int debug_level() const			/**< \brief returns current debug level */
-        { return m_debug_level; }
+        { return m_debug_level.load( std::memory_order_relaxed ); }
         
         int verbosity_level() const		/**< \brief returns current verbosity level */
-        { return m_verbosity_level; }
+        { return m_verbosity_level.load( std::memory_order_relaxed ); }
         
-        void debug_level( int debug_level )	/**< \brief can be used to set the current debug level */
-        { m_debug_level = debug_level; }
+        void debug_level( int debug_level );	/**< \brief can be used to set the current debug level */
         
         void verbosity_level( int verbosity_level );	/**< \brief can be used to set the current verbosity level */
         
+        /** Sets the debug level for the issues reported by the given package, source file or function.
+          * The scope has the "[package:|file:|function:]pattern" format, where the pattern may contain
+          * the shell wildcards, which are matched against the package name, the full source file name
+          * or the function signature. If several scopes match the same issue the last one set is used.
+          */
+        void debug_level( const std::string & scope, int debug_level );
+        
+        void reset_debug_levels();		/**< \brief removes the debug levels set for particular scopes */
+        
+        int debug_level( const char * package, const char * file, const char * function ) const;	/**< \brief returns the effective debug level for this place in the code */
+        
+        int debug_level( const ers::Context & context ) const;	/**< \brief returns the effective debug level for the issue context */
+        
+        static uint32_t generation()		/**< \brief returns the number of debug levels changes, used by ers::DebugSite */
+        { return s_generation.load( std::memory_order_acquire ); }
+        
       private:	
 	Configuration( );
+        
+	struct DebugScope
+	{
+	    enum Kind { Package, File, Function };
+	    Kind	m_kind;
+	    std::string	m_pattern;
+	    int		m_level;
+	};
                 
-        int m_debug_level;		/**< \brief current active level for the debug stream */	
-    	int m_verbosity_level;		/**< \brief current verbosity level for all streams */
+        std::atomic<int> m_debug_level;		/**< \brief current active level for the debug stream */	
+    	std::atomic<int> m_verbosity_level;	/**< \brief current verbosity level for all streams */
+        std::atomic<bool> m_has_scopes;		/**< \brief true if any debug scope is set */
+        mutable std::shared_mutex m_mutex;	/**< \brief protects the debug scopes */
+        std::vector<DebugScope> m_scopes;
+        
+        static std::atomic<uint32_t> s_generation;
+    };
+    
+    /** The \c DebugSite class caches the effective debug level for a particular place in the code,
+      * so checking whether a debug issue has to be reported costs just two loads and a compare.
+      * The cached value is recomputed whenever the debug levels are changed.
+      * It should be used via the \c ERS_DEBUG_ENABLED macro.
+      * 
+      * \brief Debug level cache of a call site.
+      */
+    class DebugSite
+    {
+      public:
+	DebugSite( const char * package, const char * file, const char * function )
+	  : m_package( package ),
+	    m_file( file ),
+	    m_function( function ),
+	    m_state( 0 )
+	{ ; }
+        
+	bool enabled( int level )
+	{
+	    uint64_t state = m_state.load( std::memory_order_relaxed );
+	    if ( ( state >> 32 ) != Configuration::generation() )
+	    {
+		state = update();
+	    }
+	    return (int32_t)( state & 0xffffffff ) >= level;
+	}
+        
+      private:
+	uint64_t update();
+        
+	const char *		m_package;
+	const char *		m_file;
+	const char *		m_function;
+	std::atomic<uint64_t>	m_state;	/**< \brief the generation in the high word and the level in the low one */
     };
     
     std::ostream & operator<<( std::ostream &, const ers::Configuration & );
@@ -40,12 +40,18 @@ namespace ers {
         /**< \brief Will be called when a new issue is received */
         void receive(const Issue &issue);
 
+        /**< \brief Is called when the stream gets its receiver, so it can start reading issues */
+        virtual void start() {
+            ;
+        }
+
     private:
         InputStream(const InputStream &other) = delete;
         InputStream& operator=(const InputStream&) = delete;
 
         void set_receiver(IssueReceiver *receiver) {
             m_receiver = receiver;
+            start();
         }
 
         IssueReceiver *m_receiver;
@@ -53,15 +59,16 @@ namespace ers {
 }
 
 #include <ers/StreamFactory.hpp>
+#include <boost/preprocessor/cat.hpp>
 
 #define ERS_REGISTER_INPUT_STREAM( class, name, params ) \
 namespace { \
-    struct InputStreamRegistrator { \
+    struct BOOST_PP_CAT( InputStreamRegistrator, __LINE__ ) { \
 	static ers::InputStream * create( const std::initializer_list<std::string> & params ) \
 	{ return new class( params ); }  \
-        InputStreamRegistrator() \
+        BOOST_PP_CAT( InputStreamRegistrator, __LINE__ ) () \
 	{ ers::StreamFactory::instance().register_in_stream( name, create ); } \
-    } registrator_mp; \
+    } BOOST_PP_CAT( registrator_mp, __LINE__ ); \
 }
 
 #endif
@@ -16,11 +16,12 @@
   */
 namespace ers
 {
+    class IssueCatcher;
     class LocalStream;
     
     /**
      * This is a helper class that is used to support issue catcher management. An instance of this class
-     * holds a reference to the last successfully registered issue catcher. When this instance is destroyed
+     * holds a reference to a successfully registered issue catcher. When this instance is destroyed
      * the issue catcher is unregistered.
      *
      * \author Serguei Kolos
@@ -34,10 +35,14 @@ namespace ers
 	~IssueCatcherHandler();
         
       private:
-	IssueCatcherHandler() = default;
+	IssueCatcherHandler( IssueCatcher * catcher )
+	  : m_catcher( catcher )
+	{ ; }
 
 	IssueCatcherHandler (const IssueCatcherHandler &) = delete;
 	IssueCatcherHandler & operator = (const IssueCatcherHandler &) = delete;
+
+	IssueCatcher * m_catcher;
     };
 }
 
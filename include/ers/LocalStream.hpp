@@ -15,12 +15,15 @@
   * \brief ers header and documentation file
   */
 
-#include <condition_variable>
+#include <stdint.h>
+
+#include <chrono>
 #include <functional>
 #include <iostream>
-#include <queue>
+#include <memory>
 #include <mutex>
-#include <thread>
+#include <string>
+#include <vector>
 
 #include <ers/Issue.hpp>
 #include <ers/IssueCatcherHandler.hpp>
@@ -34,11 +37,53 @@ ERS_DECLARE_ISSUE(  ers,					// namespace
 namespace ers
 {    
     class Issue;
+    class IssueCatcher;
     template <class > class SingletonCreator;
     
     class IssueCatcherHandler;
     
+    /** Defines what happens to a new issue when the local stream queue is full */
+    enum class OverflowPolicy
+    {
+	Block,			/**< \brief the reporting thread waits until the queue has space */
+	DropNewest,		/**< \brief the new issue is dropped */
+	DropOldest,		/**< \brief the oldest queued issue is dropped */
+	DropBelowSeverity	/**< \brief the new issue is dropped if its severity is below the threshold, otherwise the reporting thread waits */
+    };
+
+    /** Statistics of the local stream queues */
+    struct LocalStreamStatistics
+    {
+	uint64_t	enqueued;		/**< \brief number of issues passed to the queues */
+	uint64_t	dropped;		/**< \brief number of issues dropped because a queue was full */
+	size_t		high_water_mark;	/**< \brief maximum number of pending issues in a queue */
+	size_t		pending;		/**< \brief number of issues which have not been processed yet */
+    };
+
+    /** Selects the issues for an issue catcher. The issue has the severity with which it has been reported. */
+    typedef std::function<bool ( const ers::Issue & )> IssueCatcherRoute;
+
+    //! returns the route, which selects issues reported with the given severity
+    IssueCatcherRoute route_severity( ers::severity severity );
+
+    //! returns the route, which selects issues of the given class or of a class derived from it
+    IssueCatcherRoute route_class( const std::string & class_name );
+
+    //! returns the route, which selects issues having the given qualifier
+    IssueCatcherRoute route_qualifier( const std::string & qualifier );
+
     /** The \c LocalStream class can be used for passing issues between threads of the same process.
+      * The issues are passed to the local issue catchers, each of them is executed by its own pool of
+      * dedicated threads and has its own queue. A catcher may have a route, which selects the issues
+      * passed to it, so independent subsystems of an application can handle their issues in parallel.
+      * An issue is passed to all catchers which accept it, the issues which are not accepted by any
+      * catcher are sent to the ERS streams.
+      * If the pool has more than one thread the issues reported at the same place in the code may be
+      * optionally passed to the catcher in the order in which they have been reported.
+      * The number of pending issues can be limited, in which case the given overflow policy is applied
+      * to the new issues when the limit is reached. The limit can be also set via the
+      * DUNEDAQ_ERS_LOCAL_QUEUE environment variable, which has the "capacity[,policy[,severity]]" format,
+      * where the policy is one of "block", "drop-newest", "drop-oldest" or "drop-below-severity".
       *
       * \author Serguei Kolos
       * \version 1.2
@@ -54,9 +99,32 @@ namespace ers
         //! returns the singleton
         static LocalStream & instance();
 
-	//! sets local issue catcher
+	//! sets local issue catcher, which receives all issues
 	IssueCatcherHandler * set_issue_catcher( 
-        			const std::function<void ( const ers::Issue & )> & catcher );
+        			const std::function<void ( const ers::Issue & )> & catcher,
+                                unsigned int threads = 1,
+                                bool ordered = true );
+
+	//! adds local issue catcher, which receives the issues selected by the route
+	IssueCatcherHandler * add_issue_catcher( 
+        			const std::function<void ( const ers::Issue & )> & catcher,
+                                const IssueCatcherRoute & route,
+                                unsigned int threads = 1,
+                                bool ordered = true );
+
+	//! limits the number of pending issues for every catcher, 0 means no limit
+	void set_queue_limit(	size_t capacity,
+				OverflowPolicy policy = OverflowPolicy::Block,
+				ers::severity threshold = ers::Error );
+
+	//! returns statistics of the issues queues
+	LocalStreamStatistics statistics();
+
+	//! waits until all pending issues are processed by the catchers
+	void wait_until_drained();
+
+	//! waits until all pending issues are processed by the catchers or the timeout expires
+	bool wait_until_drained( std::chrono::milliseconds timeout );
 
 	void error( const ers::Issue & issue );
 	
@@ -65,25 +133,26 @@ namespace ers
         void warning( const ers::Issue & issue );
 
       private:
+	typedef std::vector<std::shared_ptr<IssueCatcher>> Catchers;
+
 	LocalStream( );
 	~LocalStream( );
         
-        void remove_issue_catcher();
+        void remove_issue_catcher( IssueCatcher * catcher );
+
+	IssueCatcherHandler * add_issue_catcher( const std::shared_ptr<IssueCatcher> & catcher );
+
+	std::shared_ptr<const Catchers> catchers() const;
 
 	void report_issue( ers::severity type, const ers::Issue & issue );
         
-	void thread_wrapper();
-
       private:
-	std::function<void ( const ers::Issue & )>	m_issue_catcher;
-	std::unique_ptr<std::thread>			m_issue_catcher_thread;
-	std::mutex					m_mutex;
-	std::condition_variable			        m_condition;
-	bool						m_terminated;
-	std::queue<ers::Issue *>			m_issues;
-	std::thread::id					m_catcher_thread_id;
+	std::shared_ptr<const Catchers>			m_catchers;	/**< \brief accessed atomically, replaced on every change */
+	std::mutex					m_mutex;	/**< \brief serializes changes of the catchers */
+	size_t						m_capacity;
+	OverflowPolicy					m_policy;
+	ers::severity					m_threshold;
     };
 }
 
 #endif
-
@@ -7,6 +7,8 @@
 #ifndef ERS_SCHEMA_HPP
 #define ERS_SCHEMA_HPP 
 
+#include <memory>
+
 #include <ers/issue.pb.h>
 #include <ers/Issue.hpp>
 
@@ -18,6 +20,10 @@ namespace ers {
   void to_schema ( const Context & c, dunedaq::ersschema::Context & out);
   void to_schema ( const Issue & i,   dunedaq::ersschema::SimpleIssue & out);
   void to_schema ( const Issue & i,   dunedaq::ersschema::IssueChain & out);
+
+  // converters back to issues, which get a remote context, the new issue takes ownership of the cause
+  std::unique_ptr<Issue> from_schema( const dunedaq::ersschema::SimpleIssue & i, const Issue * cause = nullptr );
+  std::unique_ptr<Issue> from_schema( const dunedaq::ersschema::IssueChain & chain );
   
 } // ers namespace
 
@@ -14,8 +14,10 @@
 #include <ers/Severity.hpp>
 #include <ers/Context.hpp>
 #include <ers/Issue.hpp>
+#include <ers/internal/PluginManager.hpp>
 
 #include <map>
+#include <mutex>
 
 /** \file StreamFactory.h This file defines the StreamFactory class, 
   * which is responsible for registration and creation of ERS streams.
@@ -37,6 +39,7 @@ namespace ers
     /** The \c StreamFactory class is responsible for creating a new instance of a known stream implementation.
       * This class uses singleton pattern.
       * Users should not use this class directly but use the \c ERS_REGISTER_OUTPUT_STREAM macro instead.
+      * The plugin libraries implementing the streams are loaded when one of their streams is requested for the first time.
       * 
       * \author Serguei Kolos
       * \brief Factory for ERS stream implementations.
@@ -76,6 +79,11 @@ namespace ers
 	typedef std::map<std::string, InputStreamCreator>	InFunctionMap;
 	typedef std::map<std::string, OutputStreamCreator>	OutFunctionMap;
         
+	template <class Map>
+	typename Map::mapped_type find_creator( const Map & factories, const std::string & name ) const;
+
+	mutable std::mutex		m_mutex;		/**< \brief protects the factories, which can be added by plugins at any time */
+	mutable PluginManager		m_plugin_manager;
 	InFunctionMap	m_in_factories;		/**< \brief collection of factories to build input streams */	
 	OutFunctionMap	m_out_factories;	/**< \brief collection of factories to build output streams */	
     };
@@ -19,7 +19,6 @@
 #include <ers/Context.hpp>
 #include <ers/IssueReceiver.hpp>
 #include <ers/StreamFactory.hpp>
-#include <ers/internal/PluginManager.hpp>
 
 #include <list>
 
@@ -94,13 +93,14 @@ namespace ers
       
 	void report_issue( ers::severity type, const Issue & issue );
 
+	bool initialize( bool parallel = true );	/**< \brief creates the streams for all severities */
+
       private:	
 	StreamManager( );
 
-	OutputStream * setup_stream( ers::severity severity );	
-	OutputStream * setup_stream( const std::vector<std::string> & streams );
+	OutputStream * setup_stream( ers::severity severity, bool & valid );	
+	OutputStream * setup_stream( const std::vector<std::string> & streams, bool & valid );
         
-	PluginManager					m_plugin_manager;
 	std::mutex					m_mutex;
 	std::list<std::shared_ptr<InputStream> >	m_in_streams;
 	std::shared_ptr<OutputStream>			m_init_streams[ers::Fatal + 1];	/**< \brief array of pointers to streams per severity */
@@ -48,7 +48,11 @@ namespace ers
      *	This function sets up the local issue handler function. This function will be executed in the context
      *	of dedicated thread which will be created as a result of this call. All the issues which are reported
      *	via the ers::error, ers::fatal and ers::warning functions will be forwarded to this thread.
-     *	\param issue the issue to be reported
+     *	The catcher may be executed by a pool of threads, in which case it must be thread-safe.
+     *	\param catcher the function which will be called for every issue
+     *	\param threads the number of threads which execute the catcher, default is 1
+     *	\param ordered if true the issues reported at the same place in the code are passed to the catcher
+     *			in the order in which they have been reported, even if the pool has several threads
      *	\return pointer to the handler object, which allows to remove the catcher by just destroying this object.
      *			If an applications ignores this return value there will no way of de installing the issue catcher.
      *	\throw ers::IssueCatcherAlreadySet for safety reasons local issue handler can be set only once
@@ -57,8 +61,46 @@ namespace ers
      *	\see ers::warning()
      */
     inline IssueCatcherHandler * 
-    	set_issue_catcher( const std::function<void ( const ers::Issue & )> & catcher )
-    { return LocalStream::instance().set_issue_catcher( catcher ); }
+    	set_issue_catcher( const std::function<void ( const ers::Issue & )> & catcher,
+    			   unsigned int threads = 1,
+    			   bool ordered = true )
+    { return LocalStream::instance().set_issue_catcher( catcher, threads, ordered ); }
+    
+    /*!
+     *	This function adds a local issue handler function, which receives only the issues selected by the route.
+     *	Several routed catchers can be added, each of them is executed by its own pool of threads and has its own
+     *	queue, so a slow catcher does not delay the others. An issue is passed to all catchers which accept it,
+     *	the issues which are not accepted by any catcher are sent to the ERS streams.
+     *	\param catcher the function which will be called for every selected issue
+     *	\param route the function which selects the issues, e.g. ers::route_severity() or ers::route_class()
+     *	\param threads the number of threads which execute the catcher, default is 1
+     *	\param ordered if true the issues reported at the same place in the code are passed to the catcher
+     *			in the order in which they have been reported, even if the pool has several threads
+     *	\return pointer to the handler object, which allows to remove the catcher by just destroying this object.
+     *	\see ers::set_issue_catcher()
+     */
+    inline IssueCatcherHandler * 
+    	add_issue_catcher( const std::function<void ( const ers::Issue & )> & catcher,
+    			   const IssueCatcherRoute & route,
+    			   unsigned int threads = 1,
+    			   bool ordered = true )
+    { return LocalStream::instance().add_issue_catcher( catcher, route, threads, ordered ); }
+    
+    /*!
+     *	This function performs ERS initialization, which otherwise happens when the first issue is reported:
+     *	it reads the ERS configuration and creates the streams for all severities. Calling it at the start of an
+     *	application makes the first reported issue as cheap as any other one and reveals configuration errors
+     *	before they are needed. Calling it is optional and it can be called more than once.
+     *	\param parallel if true the streams for different severities are created in parallel
+     *	\return false if the configuration of a stream has errors, in which case the problems have been printed
+     *			to the standard error stream and the default configuration is used for the respective severity
+     */
+    inline bool initialize( bool parallel = true )
+    {
+	Configuration::instance();
+	LocalStream::instance();
+	return StreamManager::instance().initialize( parallel );
+    }
     
     /*! 
      *  This function returns the current debug level for ERS.
@@ -123,6 +165,20 @@ namespace ers
 
 // ERS_DECLARE_ISSUE( ers, Message, ERS_EMPTY, ERS_EMPTY )
 
+/*!
+ *  This macro tells whether a debug issue of the given level reported at this place in the code will be
+ *  passed to the ERS DEBUG stream, taking into account the debug levels set for the current package,
+ *  source file and function. The effective level is cached per call site, so the check is cheap enough
+ *  to guard the construction of debug issues:
+ *  \code
+ *  if ( ERS_DEBUG_ENABLED( 3 ) ) { ers::debug( MyIssue( ERS_HERE, ... ), 3 ); }
+ *  \endcode
+ */
+#define ERS_DEBUG_ENABLED( level ) \
+    ( []( const char * ers_debug_function ) -> ers::DebugSite & \
+	{ static ers::DebugSite ers_debug_site( ERS_PACKAGE, __FILE__, ers_debug_function ); \
+	  return ers_debug_site; }( __PRETTY_FUNCTION__ ).enabled( level ) )
+
 #define ERS_REPORT_IMPL( stream, issue, message, level ) \
 { \
     std::ostringstream ers_report_impl_out_buffer; \
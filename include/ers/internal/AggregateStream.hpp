@@ -0,0 +1,95 @@
+/*
+ *  AggregateStream.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file AggregateStream.h This file defines AggregateStream ERS stream.
+  * \brief ers header file
+  */
+
+#ifndef ERS_AGGREGATE_STREAM_H
+#define ERS_AGGREGATE_STREAM_H
+
+#include <stdint.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <ers/OutputStream.hpp>
+
+namespace ers
+{
+    /** This stream folds issues of the same class reported with the same severity at the same place
+     * into periodic summaries. In order to employ this implementation in a stream configuration the name
+     * to be used is "aggregate". E.g. the following configuration will print at most two issues per
+     * 10 seconds for every place in the code which reports errors:
+     *
+     *         export DUNEDAQ_ERS_ERROR="aggregate(10),lstderr"
+     *
+     * This stream has the following configuration parameters:
+     *   - the length of the aggregation window in seconds, default is 10
+     *   - the names of numeric parameters separated by colons, for which the minimum, maximum and
+     *          last values are reported, e.g. "aggregate(10, link:temperature)"
+     *
+     * The first issue of every kind in a window is passed to the next stream immediately. The following ones
+     * are counted and at the end of the window a single ers::IssuesAggregated issue is sent for them. This issue
+     * has the same severity as the aggregated ones, contains their number and the statistics of the selected
+     * parameters and has the first aggregated issue as its cause. So the output volume is bounded by the number
+     * of distinct places in the code, regardless of the rate of issues. The stream is thread-safe.
+     *
+     * \brief Aggregating stream.
+     */
+    class AggregateStream : public OutputStream
+    {
+      public:
+	explicit AggregateStream( const std::string & format );
+
+	~AggregateStream();
+
+	void write( const Issue & issue ) override;
+
+      private:
+	struct Statistics
+	{
+	    double	m_min;
+	    double	m_max;
+	    double	m_last;
+	    bool	m_valid = false;
+	};
+
+	struct Entry
+	{
+	    uint64_t			m_count = 0;
+	    std::unique_ptr<Issue>	m_first;	/**< \brief the first aggregated issue */
+	    std::vector<Statistics>	m_statistics;
+	};
+
+	typedef std::unordered_map<uint64_t, Entry> Entries;
+
+	void run();
+
+	void flush();
+
+	std::chrono::seconds		m_window;
+	std::vector<std::string>	m_parameters;
+
+	std::mutex			m_mutex;
+	Entries				m_entries;
+
+	std::mutex			m_flush_mutex;
+	std::condition_variable		m_condition;
+	bool				m_terminated;
+	std::thread			m_thread;
+    };
+}
+
+#endif
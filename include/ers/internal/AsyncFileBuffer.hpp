@@ -0,0 +1,116 @@
+/*
+ *  AsyncFileBuffer.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file AsyncFileBuffer.h This file defines stream buffer which writes data to a file asynchronously.
+  * \brief ers header file
+  */
+
+#ifndef ERS_ASYNC_FILE_BUFFER_H
+#define ERS_ASYNC_FILE_BUFFER_H
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace ers
+{
+    /** This stream buffer accumulates data in a set of preallocated buffers, which are written to a file
+      * asynchronously via io_uring. The buffers are registered with the kernel once, so a write of a full
+      * buffer costs a single system call without any copying or page pinning. The file is extended in large
+      * chunks with fallocate to avoid metadata updates on every write. If io_uring is not available
+      * the buffers are written synchronously with pwrite.
+      * The buffer is submitted when it is full or when it is synchronized and the previous submission
+      * happened more than the flush interval ago. The pending data can be submitted explicitly with
+      * the flush function. Since the data are lost if the application crashes before they are written,
+      * the owner of this buffer should call the finish function when the application exits.
+      * This class is not thread-safe.
+      *
+      * \brief Asynchronous io_uring based file buffer.
+      */
+    class AsyncFileBuffer : public std::streambuf
+    {
+      public:
+	/** Opens the given file for writing, its current content is discarded.
+	  * \param file_name name of the file
+	  * \param buffer_size size of a single buffer
+	  * \param buffers_number number of buffers, which can be written concurrently
+	  * \param flush_interval maximum time the data may stay in a buffer which is not full
+	  * \throw ers::CantOpenFile the file can not be created
+	  */
+	AsyncFileBuffer( const std::string & file_name,
+			 size_t buffer_size,
+			 size_t buffers_number,
+			 std::chrono::milliseconds flush_interval );
+
+	~AsyncFileBuffer();
+
+	void flush();				/**< \brief submits the pending data for writing */
+
+	void finish();				/**< \brief writes the pending data and waits for completion */
+
+	bool asynchronous() const		/**< \brief tells if io_uring is used */
+	{ return !m_synchronous; }
+
+	std::chrono::milliseconds flush_interval() const
+	{ return m_flush_interval; }
+
+      protected:
+	int_type overflow( int_type c ) override;
+
+	int sync() override;
+
+      private:
+	AsyncFileBuffer( const AsyncFileBuffer & ) = delete;
+	AsyncFileBuffer & operator=( const AsyncFileBuffer & ) = delete;
+
+	struct Buffer
+	{
+	    char *	m_data;
+	    size_t	m_size;
+	    off_t	m_offset;
+	    bool	m_busy;
+	};
+
+	struct Ring;
+
+	bool setup_ring();
+
+	void close_ring();
+
+	bool submit();
+
+	void write_sync( Buffer & buffer, size_t done );
+
+	void reap( unsigned int wait_for );
+
+	void next_buffer();
+
+	void preallocate( off_t end );
+
+	const std::string		m_file_name;
+	const size_t			m_buffer_size;
+	const std::chrono::milliseconds	m_flush_interval;
+	int				m_fd;
+	int				m_ring_fd;
+	Ring *				m_ring;
+	bool				m_fixed;
+	bool				m_synchronous;
+	void *				m_memory;
+	std::vector<Buffer>		m_buffers;
+	size_t				m_current;
+	unsigned int			m_in_flight;
+	off_t				m_offset;
+	off_t				m_allocated;
+	std::chrono::steady_clock::time_point	m_submitted;
+    };
+}
+
+#endif
@@ -0,0 +1,70 @@
+/*
+ *  BinaryRecord.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file BinaryRecord.h This file defines compact binary representation of ERS issues.
+  * \brief ers header file
+  */
+
+#ifndef ERS_BINARY_RECORD_H
+#define ERS_BINARY_RECORD_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <string_view>
+#include <vector>
+#include <utility>
+
+namespace ers
+{
+    class Issue;
+
+    /** This class implements a compact binary encoding of an issue, which is used by the streams
+      * that have to save issues at the cost of a memory copy, e.g. crash-safe ring buffers.
+      * The encoding does not allocate memory. If the given buffer is too small the least important
+      * fields (function name, qualifiers, parameters) are truncated first.
+      * The cause of the issue is not encoded.
+      *
+      * \brief Compact binary encoding of ERS issues.
+      */
+    struct BinaryRecord
+    {
+	enum Field { ClassName, Package, File, Host, Application, Message, Function, Qualifiers, Parameters, FieldsNumber };
+
+	static const uint16_t Version = 1;
+
+	/** Encodes the given issue into the buffer.
+	  * \return number of bytes written to the buffer or 0 if the buffer is too small even for the fixed size header
+	  */
+	static size_t encode( const Issue & issue, char * buffer, size_t size );
+
+	/** Decodes a record from the buffer. The string fields of this object refer to the given buffer.
+	  * \return true if the buffer contains a valid record
+	  */
+	bool decode( const char * buffer, size_t size );
+
+        /** Creates an issue out of the decoded record.
+	  * \note the issue is allocated on the heap, it is the caller's responsibility to delete it.
+	  */
+	Issue * to_issue() const;
+
+	int64_t			m_time;			/**< \brief nanoseconds since epoch */
+	int			m_severity;		/**< \brief ers::severity value */
+	int			m_rank;			/**< \brief debug level */
+	pid_t			m_pid;			/**< \brief process id */
+	pid_t			m_tid;			/**< \brief thread id */
+	int			m_uid;			/**< \brief user id */
+	int			m_line;			/**< \brief line number */
+	std::string_view	m_fields[FieldsNumber];	/**< \brief raw string fields */
+
+	std::vector<std::string_view> qualifiers() const;
+	std::vector<std::pair<std::string_view,std::string_view> > parameters() const;
+    };
+}
+
+#endif
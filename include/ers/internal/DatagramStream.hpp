@@ -0,0 +1,146 @@
+/*
+ *  DatagramStream.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file DatagramStream.h This file defines DatagramOutStream and DatagramInStream ERS streams.
+  * \brief ers header file
+  */
+
+#ifndef ERS_DATAGRAM_STREAM_H
+#define ERS_DATAGRAM_STREAM_H
+
+#include <sys/socket.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ers/InputStream.hpp>
+#include <ers/OutputStream.hpp>
+
+namespace ers
+{
+    /** Address of a datagram socket given in the configuration of a stream.
+      * An UDP address has the "host:port" form, the host may be omitted for the input stream.
+      * An Unix domain socket address is a path name, or a name in the abstract namespace if it starts with '@'.
+      */
+    struct DatagramAddress
+    {
+	DatagramAddress( int family, const std::string & address, bool local );
+
+	std::string		m_name;
+	sockaddr_storage	m_address;
+	socklen_t		m_length;
+	int			m_family;
+    };
+
+    /** This stream sends issues to another process via UDP or Unix domain datagram sockets.
+     * Every issue is serialized with the ERS protobuf schema and several issues are combined into one datagram.
+     * In order to employ this implementation in a stream configuration the name to be used is either "udp" or "unix".
+     * E.g. the following configuration will send all errors to the collector running on the "daq-logs" host:
+     *
+     *         export DUNEDAQ_ERS_ERROR="lstderr,udp(daq-logs:5140)"
+     *
+     * This stream has the following configuration parameters:
+     *   - the destination address
+     *   - the maximum size of a datagram, which may have k suffix. Default value is 8k.
+     *
+     * The datagrams are sent by a background thread, which flushes them every 10 milliseconds or as soon as
+     * a datagram is full, using a single system call for all pending datagrams. The stream never blocks,
+     * issues are dropped and counted if the socket buffer is full or if the receiver is not available.
+     * An issue that does not fit into a datagram loses its causes and then the tail of its message.
+     * The stream is thread-safe.
+     *
+     * \brief Datagram output stream.
+     */
+    class DatagramOutStream : public OutputStream
+    {
+      public:
+	static const size_t DefaultDatagramSize = 8192;
+	static const size_t MaxPendingDatagrams = 64;
+
+	DatagramOutStream( int family, const std::string & format );
+
+	~DatagramOutStream();
+
+	void write( const Issue & issue ) override;
+
+	uint64_t dropped() const			/**< \brief number of issues dropped so far */
+	{ return m_dropped; }
+
+      private:
+	struct Datagram
+	{
+	    std::string	m_data;
+	    size_t	m_issues = 0;
+	};
+
+	Datagram take_free();
+
+	void run();
+
+	void flush();
+
+	void send( std::vector<Datagram> & datagrams );
+
+	void report_dropped( bool force );
+
+	DatagramAddress			m_address;
+	size_t				m_datagram_size;
+	int				m_socket;
+	std::atomic<uint64_t>		m_dropped;
+
+	std::mutex			m_mutex;
+	std::condition_variable		m_condition;
+	Datagram			m_current;
+	std::vector<Datagram>		m_ready;
+	std::vector<Datagram>		m_free;
+	bool				m_terminated;
+
+	// used by the background thread and the exit handler, which are serialized by the flush mutex
+	std::mutex			m_flush_mutex;
+	std::vector<Datagram>		m_sending;
+	uint64_t			m_reported;
+	std::chrono::steady_clock::time_point	m_last_report;
+	std::thread			m_thread;
+    };
+
+    /** This stream receives issues sent by the "udp" or "unix" output streams of other processes.
+     * The input stream takes the address to listen at as the only parameter, for example:
+     *
+     *         ers::StreamManager::instance().add_receiver( "udp", { "5140" }, receiver );
+     *         ers::StreamManager::instance().add_receiver( "unix", { "/run/daq/node-logs" }, receiver );
+     *
+     * An existing socket file is replaced. The receiver is called by a dedicated thread.
+     *
+     * \brief Datagram input stream.
+     */
+    class DatagramInStream : public InputStream
+    {
+      public:
+	DatagramInStream( int family, const std::initializer_list<std::string> & params );
+
+	~DatagramInStream();
+
+      protected:
+	void start() override;
+
+      private:
+	void run();
+
+	DatagramAddress		m_address;
+	int			m_socket;
+	std::atomic<bool>	m_terminated;
+	std::thread		m_thread;
+    };
+}
+
+#endif
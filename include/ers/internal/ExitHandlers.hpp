@@ -0,0 +1,66 @@
+/*
+ *  ExitHandlers.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file ExitHandlers.h This file defines the registry of functions called at the application exit.
+  * \brief ers header file
+  */
+
+#ifndef ERS_EXIT_HANDLERS_H
+#define ERS_EXIT_HANDLERS_H
+
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <mutex>
+
+namespace ers
+{
+    /** ERS streams are never destroyed, so the streams which keep issues in memory
+      * have to be flushed explicitly when the application exits.
+      *
+      * \brief Functions called at the application exit.
+      */
+    struct ExitHandlers
+    {
+	static void add( const void * owner, const std::function<void ()> & handler )
+	{
+	    std::scoped_lock lock( mutex() );
+	    static bool registered = !std::atexit( run );
+	    (void)registered;
+	    handlers()[owner] = handler;
+	}
+
+	static void remove( const void * owner )
+	{
+	    std::scoped_lock lock( mutex() );
+	    handlers().erase( owner );
+	}
+
+      private:
+	static void run()
+	{
+	    std::scoped_lock lock( mutex() );
+	    for ( auto & h : handlers() )
+		h.second();
+	}
+
+	static std::mutex & mutex()
+	{
+	    static std::mutex * m = new std::mutex;
+	    return *m;
+	}
+
+	static std::map<const void *, std::function<void ()> > & handlers()
+	{
+	    static auto * h = new std::map<const void *, std::function<void ()> >;
+	    return *h;
+	}
+    };
+}
+
+#endif
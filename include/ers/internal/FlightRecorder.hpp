@@ -0,0 +1,52 @@
+/*
+ *  FlightRecorder.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file FlightRecorder.h This file defines ERS FlightRecorder class.
+  * \brief ers header file
+  */
+
+#ifndef ERS_FLIGHT_RECORDER_H
+#define ERS_FLIGHT_RECORDER_H
+
+#include <iostream>
+
+namespace ers
+{
+    class Issue;
+
+    /** The \c FlightRecorder keeps a fixed number of the most recent issues reported by every thread
+      * of the application. The issues are stored in compact binary form in per-thread ring buffers,
+      * which are printed by the ERS signal and terminate handlers when the application crashes.
+      * The crash handlers format the records directly from the ring buffers, so the time stamps use the
+      * time zone offset which was in effect when the first issue was recorded.
+      * The recorder is controlled by the following environment variables:
+      *   - DUNEDAQ_ERS_FLIGHT_RECORDER - number of issues kept per thread, 0 disables the recorder.
+      *		Default value is 32.
+      *   - DUNEDAQ_ERS_FLIGHT_RECORDER_DEBUG_LEVEL - debug issues up to this level are recorded even if
+      *		they are not reported because of the current ERS debug level. Default value is -1,
+      *		i.e. only the debug issues that pass the current debug level are recorded.
+      *
+      * \brief Per-thread history of the recent issues.
+      */
+    class FlightRecorder
+    {
+      public:
+	static void record( const Issue & issue );	/**< \brief saves the issue in the current thread history */
+
+	static bool records_debug( int level );		/**< \brief tells if debug issues of this level are recorded */
+
+	static void dump( std::ostream & out );		/**< \brief prints history of all threads ordered by time */
+
+	/** Writes history of all threads ordered by time to the given file descriptor. This function neither
+	  * allocates memory nor takes locks, so it is safe to use in signal handlers and in a corrupted heap.
+	  */
+	static void dump( int fd );
+    };
+}
+
+#endif
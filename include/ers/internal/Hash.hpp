@@ -0,0 +1,84 @@
+/*
+ *  Hash.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file Hash.h This file defines fast non-cryptographic hash functions used by ERS streams.
+  * \brief ers header file
+  */
+
+#ifndef ERS_HASH_H
+#define ERS_HASH_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+
+namespace ers
+{
+    namespace hash_constants
+    {
+	const uint64_t P0 = 0xa0761d6478bd642full;
+	const uint64_t P1 = 0xe7037ed1a0b428dbull;
+	const uint64_t P2 = 0x8ebc6af09c88c6e3ull;
+    }
+
+    /** \brief Mixes two 64 bit values by multiplying them and folding the 128 bit product. */
+    inline uint64_t
+    hash_mix( uint64_t a, uint64_t b )
+    {
+	__uint128_t r = (__uint128_t)a * b;
+	return (uint64_t)r ^ (uint64_t)( r >> 64 );
+    }
+
+    /** \brief Combines a hash value with another 64 bit value. */
+    inline uint64_t
+    hash_combine( uint64_t hash, uint64_t value )
+    {
+	return hash_mix( hash ^ hash_constants::P0, value ^ hash_constants::P1 );
+    }
+
+    /** Computes hash of a byte sequence, processing it by 8 byte words.
+      * \brief Fast non-cryptographic 64 bit hash function.
+      */
+    inline uint64_t
+    hash( const void * data, size_t size, uint64_t seed = 0 )
+    {
+	const uint8_t * p = static_cast<const uint8_t *>( data );
+	uint64_t h = seed ^ hash_mix( size ^ hash_constants::P0, hash_constants::P1 );
+
+	for ( ; size >= 8; p += 8, size -= 8 )
+	{
+	    uint64_t w;
+	    ::memcpy( &w, p, 8 );
+	    h = hash_mix( w ^ hash_constants::P1, h ^ hash_constants::P2 );
+	}
+
+	if ( size )
+	{
+	    uint64_t w = 0;
+	    ::memcpy( &w, p, size );
+	    h = hash_mix( w ^ hash_constants::P1, h ^ hash_constants::P2 );
+	}
+
+	return hash_mix( h ^ hash_constants::P0, hash_constants::P2 );
+    }
+
+    inline uint64_t
+    hash( const char * s, uint64_t seed = 0 )
+    {
+	return hash( s, ::strlen( s ), seed );
+    }
+
+    inline uint64_t
+    hash( const std::string & s, uint64_t seed = 0 )
+    {
+	return hash( s.data(), s.size(), seed );
+    }
+}
+
+#endif
@@ -0,0 +1,121 @@
+/*
+ *  IssueCatcher.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file IssueCatcher.h This file defines the IssueCatcher class used by the LocalStream.
+  * \brief ers header file
+  */
+
+#ifndef ERS_ISSUE_CATCHER_H
+#define ERS_ISSUE_CATCHER_H
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <ers/LocalStream.hpp>
+
+namespace ers
+{
+    /** This class executes an issue catcher function by a pool of dedicated threads. It has its own
+      * queue of issues, which can be bounded, and an optional route, which selects the issues for this catcher.
+      *
+      * The reporting threads pass issues to the catcher threads via a lock-free list, so they don't
+      * contend with each other and with the catcher threads. A catcher thread takes all issues from
+      * the list at once and a reporting thread wakes it up only if it is waiting for new issues.
+      * If the pool has more than one thread the issues reported at the same place in the code may be
+      * passed to the catcher function in the order in which they have been reported.
+      *
+      * \brief Issue catcher executor.
+      */
+    class IssueCatcher
+    {
+      public:
+	IssueCatcher(	const std::function<void ( const ers::Issue & )> & catcher,
+			const IssueCatcherRoute & route,
+			unsigned int threads,
+			bool ordered );
+
+	~IssueCatcher();
+
+	//! returns true if the current thread is one of the catcher threads
+	static bool in_catcher_thread();
+
+	bool has_route() const
+	{ return static_cast<bool>( m_route ); }
+
+	bool accepts( const ers::Issue & issue ) const
+	{ return !m_route || m_route( issue ); }
+
+	//! passes a copy of the issue to the catcher, returns false if the catcher has been stopped
+	bool report( const ers::Issue & issue );
+
+	//! stops the catcher threads and deletes the pending issues
+	void stop();
+
+	void set_queue_limit( size_t capacity, OverflowPolicy policy, ers::severity threshold );
+
+	void add_statistics( LocalStreamStatistics & statistics ) const;
+
+	bool wait_until_drained( const std::chrono::steady_clock::time_point & deadline );
+
+      private:
+	enum class Admission { Accepted, Dropped, NoCatcher };
+
+	struct PendingIssue
+	{
+	    ers::Issue *	m_issue;
+	    PendingIssue *	m_next;
+	};
+
+	Admission admit( ers::severity type );
+
+	void push( ers::Issue * issue );
+
+	void take_issues();
+
+	void thread_wrapper();
+
+	void process_issue( std::unique_lock<std::mutex> & lock, ers::Issue * issue );
+
+	void issue_processed();
+
+	void update_high_water_mark( size_t pending );
+
+	std::function<void ( const ers::Issue & )>	m_issue_catcher;
+	IssueCatcherRoute				m_route;
+	bool						m_ordered;
+	std::vector<std::thread>			m_threads;
+	std::atomic<bool>				m_active;
+	std::atomic<PendingIssue *>			m_head;		/**< \brief lock-free list of the new issues in reverse order */
+	std::atomic<unsigned int>			m_sleepers;	/**< \brief number of catcher threads waiting for new issues */
+	std::mutex					m_mutex;
+	std::condition_variable			        m_condition;
+	bool						m_terminated;
+	std::queue<ers::Issue *>			m_issues;
+	std::unordered_map<uint64_t, std::queue<ers::Issue *>>	m_busy_sites;	/**< \brief issues waiting for the site being processed */
+	std::condition_variable				m_space_condition;
+	unsigned int					m_waiters;	/**< \brief number of threads waiting on the m_space_condition */
+	std::atomic<size_t>				m_capacity;
+	OverflowPolicy					m_policy;
+	ers::severity					m_threshold;
+	std::atomic<size_t>				m_pending;
+	std::atomic<uint64_t>				m_enqueued;
+	std::atomic<uint64_t>				m_dropped;
+	std::atomic<size_t>				m_high_water_mark;
+    };
+}
+
+#endif
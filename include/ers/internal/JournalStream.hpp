@@ -0,0 +1,65 @@
+/*
+ *  JournalStream.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file JournalStream.h This file defines JournalStream ERS stream.
+  * \brief ers header file
+  */
+
+#ifndef ERS_JOURNAL_STREAM_H
+#define ERS_JOURNAL_STREAM_H
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <atomic>
+#include <string>
+
+#include <ers/OutputStream.hpp>
+
+namespace ers
+{
+    /** This stream sends issues to the systemd journal using the native journal protocol.
+     * In order to employ this implementation in a stream configuration the name to be used is "journal".
+     * E.g. the following configuration will send all errors and warnings to the journal:
+     *
+     *         export DUNEDAQ_ERS_ERROR="journal"
+     *         export DUNEDAQ_ERS_WARNING="journal"
+     *
+     * The stream takes an optional parameter, which is the path of the journal socket.
+     * Default value is /run/systemd/journal/socket.
+     *
+     * Every issue is sent as a single datagram, which in addition to the MESSAGE, PRIORITY, CODE_FILE, CODE_LINE,
+     * CODE_FUNC and SYSLOG_IDENTIFIER journal fields contains the ERS_CLASS, ERS_SEVERITY, ERS_PACKAGE, ERS_HOST,
+     * ERS_PID, ERS_TID, ERS_USER, ERS_CWD and ERS_TIME_USEC fields, one ERS_QUALIFIER field for every qualifier,
+     * one ERS_PARAM_<NAME> field for every parameter and one ERS_CAUSE field for every cause of the issue.
+     * A datagram which is too large for the socket is passed to the journal via a sealed memfd.
+     * The stream is thread-safe.
+     *
+     * \brief Journal stream.
+     */
+    class JournalStream : public OutputStream
+    {
+      public:
+	explicit JournalStream( const std::string & socket_path );
+
+	~JournalStream();
+
+	void write( const Issue & issue ) override;
+
+      private:
+	bool send_memfd( const std::string & data );
+
+	std::string		m_path;
+	sockaddr_un		m_address;
+	socklen_t		m_length;
+	int			m_socket;
+	std::atomic<bool>	m_failed;
+    };
+}
+
+#endif
@@ -0,0 +1,97 @@
+/*
+ *  MMapRing.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file MMapRing.h This file defines memory-mapped circular buffer of binary issue records.
+  * \brief ers header file
+  */
+
+#ifndef ERS_MMAP_RING_H
+#define ERS_MMAP_RING_H
+
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+
+#include <ers/internal/BinaryRecord.hpp>
+
+namespace ers
+{
+    class Issue;
+
+    /** This class implements a fixed-size circular buffer of binary issue records, which is mapped to a file.
+      * The buffer is split into slots of equal size. A writer reserves a slot by atomically incrementing
+      * a sequence counter stored in the file header, so the buffer can be safely shared by multiple threads
+      * and processes without locking. As the data are written directly to the mapped memory they
+      * survive a crash of the process that has written them.
+      *
+      * \brief Crash-safe memory-mapped ring buffer of issues.
+      */
+    class MMapRing
+    {
+      public:
+	static const size_t SlotSize = 1024;
+
+	/** Opens the given file for writing. If the file does not exist or has incompatible layout
+	  * it is created anew, otherwise the new records are appended to the existing ones.
+	  * \param file_name name of the file
+	  * \param size size of the file in bytes
+	  * \throw ers::CantOpenFile the file can not be created or mapped
+	  */
+	MMapRing( const std::string & file_name, size_t size );
+
+	/** Opens an existing file in read-only mode.
+	  * \param file_name name of the file
+	  * \throw ers::CantOpenFile the file does not exist or has invalid format
+	  */
+	explicit MMapRing( const std::string & file_name );
+
+	/** Creates a ring in anonymous private memory, which can be used as in-process flight recorder.
+	  * \param records maximum number of records in the ring
+	  */
+	explicit MMapRing( size_t records );
+
+	~MMapRing();
+
+	void write( const Issue & issue );			/**< \brief stores the issue in the next free slot */
+
+	/** Calls the given function for each valid record in the order of their sequence numbers.
+	  * The record refers to a temporary buffer, which is only valid during the function call.
+	  */
+	void for_each( const std::function<void ( uint64_t sequence, const BinaryRecord & record )> & f ) const;
+
+	/** Copies the record with the given sequence number to the buffer. This method neither allocates
+	  * memory nor takes locks, so it can be used in signal handlers.
+	  * \return length of the record or 0 if the slot does not hold this record
+	  */
+	size_t read( uint64_t sequence, char * buffer, size_t size ) const;
+
+	uint64_t written() const;				/**< \brief total number of records ever written */
+
+	size_t capacity() const					/**< \brief maximum number of records in the buffer */
+	{ return m_slots_number; }
+
+      private:
+	MMapRing( const MMapRing & ) = delete;
+	MMapRing & operator=( const MMapRing & ) = delete;
+
+	struct Header;
+	struct Slot;
+
+	void map( const std::string & file_name, int fd, size_t size, bool writable );
+
+	Slot & slot( uint64_t sequence ) const;
+
+	void *		m_address;
+	size_t		m_size;
+	Header *	m_header;
+	size_t		m_slots_number;
+    };
+}
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ *  MMapRingStream.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file MMapRingStream.h This file defines MMapRingStream ERS stream.
+  * \brief ers header file
+  */
+
+#ifndef ERS_MMAP_RING_STREAM_H
+#define ERS_MMAP_RING_STREAM_H
+
+#include <memory>
+
+#include <ers/OutputStream.hpp>
+#include <ers/internal/MMapRing.hpp>
+
+namespace ers
+{
+    /** This stream writes issues as compact binary records to a fixed-size circular buffer, which is
+     * mapped to a file. As the records are written directly to the mapped memory they are not lost
+     * if the application crashes or gets killed. The content of the file can be printed with the
+     * ers_ringdump utility.
+     * In order to employ this implementation in a stream configuration the name to be used is "mmapring".
+     * E.g. the following configuration will keep the last ERROR issues in the /tmp/errors.ring file:
+     *
+     *         export DUNEDAQ_ERS_ERROR="lstderr,mmapring(/tmp/errors.ring,16M)"
+     *
+     * This stream has two configuration parameters:
+     *   - the name of the file
+     *   - the size of the file, which may have k, M or G suffix. Default size is 16M.
+     *
+     * The stream is thread-safe and the same file can be used by several processes simultaneously.
+     *
+     * \brief Crash-safe ring buffer stream.
+     */
+    class MMapRingStream : public OutputStream
+    {
+      public:
+	explicit MMapRingStream( const std::string & format );
+
+	void write( const Issue & issue ) override;
+
+      private:
+	std::unique_ptr<MMapRing>	m_ring;
+    };
+}
+
+#endif
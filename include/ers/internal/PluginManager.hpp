@@ -17,6 +17,8 @@
 
 #include <string>
 #include <map>
+#include <mutex>
+#include <vector>
 
 namespace ers
 {
@@ -55,17 +57,30 @@ namespace ers
 	};
 
 	typedef std::map< std::string, SharedLibrary* > LibMap;
+	typedef std::map< std::string, std::string > Manifest;
 
-	LibMap	    libraries_;
+	bool load_library( const std::string & name );
+
+	std::recursive_mutex		mutex_;
+	LibMap				libraries_;
+	Manifest			manifest_;	/**< \brief maps stream names to the names of the libraries implementing them */
+	std::vector<std::string>	unmapped_;	/**< \brief libraries which streams are not known in advance */
 
       public:
-	/** Constructor loads the plugins.
+	/** Constructor reads the plugins manifest, the plugins are loaded on demand.
 	 */
 	PluginManager();
 
 	/** Destructor unloads the plugins.
 	 */
 	~PluginManager();
+
+	/** Loads the library which implements the given stream. If the stream is not in the manifest
+	    all the libraries given without the stream names are loaded.
+	    @param stream Name of the stream
+	    @return true if a new library has been loaded
+	 */
+	bool load( const std::string & stream );
     };
 }
 
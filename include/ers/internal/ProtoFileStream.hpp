@@ -0,0 +1,81 @@
+/*
+ *  ProtoFileStream.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file ProtoFileStream.h This file defines ProtoFileOutStream and ProtoFileInStream ERS streams.
+  * \brief ers header file
+  */
+
+#ifndef ERS_PROTO_FILE_STREAM_H
+#define ERS_PROTO_FILE_STREAM_H
+
+#include <atomic>
+#include <thread>
+
+#include <ers/InputStream.hpp>
+#include <ers/OutputStream.hpp>
+
+namespace ers
+{
+    /** This stream appends issues to a file as a sequence of protobuf IssueChain messages, each one
+     * prefixed with its length encoded as a varint. Every issue is written with a single system call,
+     * so several processes may append to the same file simultaneously.
+     * In order to employ this implementation in a stream configuration the name to be used is "protofile".
+     * E.g. the following configuration will save all errors to the /tmp/errors.pb file:
+     *
+     *         export DUNEDAQ_ERS_ERROR="lstderr,protofile(/tmp/errors.pb)"
+     *
+     * The stream is thread-safe.
+     *
+     * \brief Protobuf file output stream.
+     */
+    class ProtoFileOutStream : public OutputStream
+    {
+      public:
+	explicit ProtoFileOutStream( const std::string & file_name );
+
+	~ProtoFileOutStream();
+
+	void write( const Issue & issue ) override;
+
+      private:
+	const std::string	m_file_name;
+	int			m_fd;
+    };
+
+    /** This stream reads issues from a file written by the "protofile" output streams. The file is read
+     * from the beginning and then is followed for the new issues, similar to the "tail -f" command.
+     * The file is created if it does not exist yet.
+     * The input stream takes the name of the file as the only parameter:
+     *
+     *         ers::StreamManager::instance().add_receiver( "protofile", { "/tmp/errors.pb" }, receiver );
+     *
+     * The receiver is called by a dedicated thread.
+     *
+     * \brief Protobuf file input stream.
+     */
+    class ProtoFileInStream : public InputStream
+    {
+      public:
+	explicit ProtoFileInStream( const std::initializer_list<std::string> & params );
+
+	~ProtoFileInStream();
+
+      protected:
+	void start() override;
+
+      private:
+	void run();
+
+	const std::string	m_file_name;
+	int			m_fd;
+	std::atomic<bool>	m_terminated;
+	std::thread		m_thread;
+    };
+}
+
+#endif
@@ -15,6 +15,11 @@
 #ifndef ERS_STREAM_RFILTER_H 
 #define ERS_STREAM_RFILTER_H
 
+#include <stdint.h>
+
+#include <shared_mutex>
+#include <unordered_map>
+
 #include <ers/OutputStream.hpp>
 #include <boost/regex.hpp>
 
@@ -33,6 +38,11 @@ namespace ers
       *  \li rfilter(!create.*,!new.*) - this stream will pass messages that have originated
       *         from a function that starts with neither "create" nor "new" string.
       *
+      * All include and all exclude expressions are compiled into a single regular expression each,
+      * so every issue is matched at most twice per function name and qualifier. The decisions are
+      * remembered for every combination of the function name and qualifiers, therefore in the steady
+      * state the cost of filtering is a single hash table lookup.
+      *
       * \brief Filtering stream implementation.
       */
     
@@ -46,8 +56,17 @@ namespace ers
       private:	    
         bool is_accepted( const ers::Issue & issue );
 
-        std::vector<boost::regex> m_regInclude;         /**< \brief include list */
-        std::vector<boost::regex> m_regExclude;         /**< \brief exclude list */
+        bool match( const ers::Issue & issue, const char * function, size_t length );
+
+        static const size_t MaxDecisions = 4096;
+
+        bool m_hasInclude;
+        bool m_hasExclude;
+        boost::regex m_regInclude;                      /**< \brief include list compiled as one expression */
+        boost::regex m_regExclude;                      /**< \brief exclude list compiled as one expression */
+
+        std::shared_mutex m_mutex;
+        std::unordered_map<uint64_t, bool> m_decisions; /**< \brief decisions for (function, qualifiers) */
     };
 }
 
@@ -0,0 +1,102 @@
+/*
+ *  RateLimitStream.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file RateLimitStream.h This file defines RateLimitStream ERS stream.
+  * \brief ers header file
+  */
+
+#ifndef ERS_RATE_LIMIT_STREAM_H
+#define ERS_RATE_LIMIT_STREAM_H
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <ers/OutputStream.hpp>
+#include <ers/Severity.hpp>
+
+namespace ers
+{
+    /** This stream limits the rate of issues passed to the next stream in the chain, regardless of whether
+     * they are identical or not. In order to employ this implementation in a stream configuration the name
+     * to be used is "ratelimit". E.g. the following configuration will pass at most 100 errors per second
+     * to the standard error, allowing short bursts of up to 500 issues:
+     *
+     *         export DUNEDAQ_ERS_ERROR="ratelimit(100, 500),lstderr"
+     *
+     * This stream has the following configuration parameters:
+     *   - the number of issues per second, default is 100
+     *   - the maximum burst size, default is the number of issues per second
+     *   - the key, which defines how the budget is shared:
+     *          - "global" - all issues share one budget, this is the default
+     *          - "package" - every package has its own budget
+     *          - "severity" - all issues share one budget with severity priority, i.e. the issues of a
+     *                  lower severity can use only a part of the burst and the rest of it is reserved for
+     *                  the higher ones. Errors can use the whole burst, warnings 4/5 of it, information
+     *                  3/5, log 2/5 and debug 1/5.
+     *          - "severity:package" - every package has its own budget with severity priority
+     *   - the interval in seconds between the reports about the dropped issues, default is 10
+     *
+     * All "ratelimit" streams with the same parameters share their budgets, so the following configuration
+     * limits the total rate of warnings and errors to 1000 per second. A storm of warnings can not use
+     * the last 200 issues of the burst, which remain available to errors:
+     *
+     *         export DUNEDAQ_ERS_WARNING="ratelimit(1000, 1000, severity),lstderr"
+     *         export DUNEDAQ_ERS_ERROR="ratelimit(1000, 1000, severity),lstderr"
+     *
+     * The budgets are token buckets implemented with a single atomic variable each, so the stream never locks
+     * except when it creates the budget of a new package.
+     * Fatal issues are never dropped. The number of dropped issues is periodically reported to the next
+     * stream with an ers::IssuesDropped issue, which has the highest severity of the dropped ones.
+     * The last report is made when the application exits.
+     * The stream is thread-safe.
+     *
+     * \brief Rate limiting stream.
+     */
+    class RateLimitStream : public OutputStream
+    {
+      public:
+	explicit RateLimitStream( const std::string & format );
+
+	~RateLimitStream();
+
+	void write( const Issue & issue ) override;
+
+      private:
+	struct Bucket;
+	struct Buckets;
+
+	bool acquire( Bucket & bucket, int64_t now, int64_t tolerance );
+
+	void run();
+
+	void report();
+
+	int64_t			m_period;		/**< \brief time per issue in nanoseconds */
+	int64_t			m_tolerance[ers::Fatal];	/**< \brief part of the burst size available to every severity in nanoseconds */
+	bool			m_per_severity;
+	bool			m_per_package;
+	std::shared_ptr<Buckets>	m_buckets;
+
+	std::atomic<uint64_t>	m_dropped;
+	std::atomic<int>	m_max_severity;
+
+	std::chrono::seconds	m_report_interval;
+	std::mutex		m_mutex;
+	std::condition_variable	m_condition;
+	bool			m_terminated;
+	std::thread		m_thread;
+    };
+}
+
+#endif
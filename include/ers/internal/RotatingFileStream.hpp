@@ -0,0 +1,99 @@
+/*
+ *  RotatingFileStream.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file RotatingFileStream.h This file defines RotatingFileStream ERS stream.
+  * \brief ers header file
+  */
+
+#ifndef ERS_ROTATING_FILE_STREAM_H
+#define ERS_ROTATING_FILE_STREAM_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <ers/OutputStream.hpp>
+
+namespace ers
+{
+    /** This stream prints issues to a file, which is rotated when it exceeds the given size or age.
+     * The active file is renamed to <file_name>.<date>-<time>-<number> and a new file is opened before
+     * the old one gets closed, so no issue is ever lost. The rotated files are compressed with gzip
+     * by a low priority background thread, which also removes the oldest ones. The files which have not
+     * been compressed before the application exit are compressed next time the stream is created.
+     * In order to employ this implementation in a stream configuration the name to be used is "rfile".
+     * E.g. the following configuration will rotate the log file every 100 MB or every day and keep the
+     * last 10 rotated files:
+     *
+     *         export DUNEDAQ_ERS_LOG="rfile(/tmp/log.txt,100M,1d,10)"
+     *
+     * This stream has the following configuration parameters:
+     *   - the name of the file
+     *   - maximum file size, which may have k, M or G suffix, 0 means no limit. Default value is 100M.
+     *   - maximum file age, which may have s, m, h or d suffix, 0 means no limit. Default value is 0.
+     *   - number of rotated files to keep, 0 means keep all of them. Default value is 10.
+     *
+     * This stream is thread-safe.
+     *
+     * \brief Rotating file stream.
+     */
+    class RotatingFileStream : public OutputStream
+    {
+      public:
+	explicit RotatingFileStream( const std::string & format );
+
+	~RotatingFileStream();
+
+	void write( const Issue & issue ) override;
+
+      private:
+	// unbuffered front-end of a file buffer, which counts the number of bytes written
+	struct CountingBuffer : public std::streambuf
+	{
+	    std::streamsize xsputn( const char * s, std::streamsize n ) override;
+	    int_type overflow( int_type c ) override;
+	    int sync() override;
+
+	    std::filebuf	m_file;
+	    size_t		m_written = 0;
+	};
+
+	void open();
+
+	void rotate();
+
+	void compressor();
+
+	void compress( const std::string & file_name );
+
+	void remove_old_files();
+
+	std::string				m_file_name;
+	size_t					m_max_size;
+	std::chrono::seconds			m_max_age;
+	size_t					m_keep;
+
+	std::mutex				m_mutex;
+	std::unique_ptr<CountingBuffer>		m_buffer;
+	std::ostream				m_out;
+	std::chrono::system_clock::time_point	m_opened;
+	unsigned int				m_counter;
+
+	std::mutex				m_compressor_mutex;
+	std::condition_variable			m_compressor_condition;
+	std::deque<std::string>			m_to_compress;
+	bool					m_terminated;
+	std::thread				m_compressor;
+    };
+}
+
+#endif
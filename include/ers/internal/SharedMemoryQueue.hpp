@@ -0,0 +1,105 @@
+/*
+ *  SharedMemoryQueue.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file SharedMemoryQueue.h This file defines shared memory queue of issues.
+  * \brief ers header file
+  */
+
+#ifndef ERS_SHARED_MEMORY_QUEUE_H
+#define ERS_SHARED_MEMORY_QUEUE_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace ers
+{
+    class Issue;
+
+    /** This class implements a bounded lock-free queue of serialized issues in a POSIX shared memory object,
+      * which can be used to pass issues from any number of processes to a single consumer process.
+      * The queue consists of fixed size slots, each one holding a single issue chain serialized with
+      * the ERS protobuf schema. An issue that does not fit into a slot loses its causes and then the tail of
+      * its message. A producer never blocks: if the queue is full the issue is dropped and counted.
+      * The consumer sleeps on a futex located in the shared memory when the queue is empty, so the producers
+      * make a system call only when the consumer has to be woken up. A slot, which has been reserved by
+      * a producer that died before completing it, is skipped by the consumer after a timeout. A producer
+      * which has been stalled for longer than this timeout in the middle of a write may spoil one record.
+      * The reading position is kept in the shared memory, so a restarted consumer continues where
+      * the previous one has stopped.
+      * The shared memory object is accessible only to its owner by default. Other users can be allowed
+      * to use the queue by giving their group access to it. An existing object is used only if it
+      * belongs to the current user, or if the group access is requested and the object belongs to the
+      * current group and is not accessible to other users.
+      *
+      * \brief Multi-producer single-consumer shared memory queue of issues.
+      */
+    class SharedMemoryQueue
+    {
+      public:
+	static const size_t DefaultSize = 16 << 20;
+	static const size_t DefaultSlotSize = 4096;
+	static const mode_t DefaultMode = 0600;
+
+	/** Opens the shared memory object with the given name, creating it if it does not exist.
+	  * If the object already exists its size and slot size are used instead of the given ones.
+	  * \param name name of the shared memory object
+	  * \param size size of the queue in bytes
+	  * \param slot_size maximum size of a single serialized issue chain
+	  * \param consumer if true the queue is open for reading, only one consumer may exist at a time
+	  * \param mode access mode of the shared memory object
+	  * \throw ers::CantOpenFile the object can not be created or it has a consumer already
+	  * \throw ers::PermissionDenied the existing object may be modified by untrusted users
+	  */
+	SharedMemoryQueue( const std::string & name, size_t size, size_t slot_size, bool consumer,
+			   mode_t mode = DefaultMode );
+
+	~SharedMemoryQueue();
+
+	/** Puts the issue to the queue.
+	  * \return false if the issue has been dropped
+	  */
+	bool push( const Issue & issue );
+
+	/** Takes the next issue from the queue, waiting for the given time if the queue is empty.
+	  * \return the issue or null pointer if no issue is available
+	  */
+	std::unique_ptr<Issue> pop( std::chrono::milliseconds timeout );
+
+	uint64_t dropped() const;		/**< \brief number of issues dropped by all producers */
+
+	size_t capacity() const			/**< \brief maximum number of issues in the queue */
+	{ return m_slots_number; }
+
+      private:
+	SharedMemoryQueue( const SharedMemoryQueue & ) = delete;
+	SharedMemoryQueue & operator=( const SharedMemoryQueue & ) = delete;
+
+	struct Header;
+	struct Slot;
+
+	Slot & slot( uint64_t position ) const;
+
+	void wait( std::chrono::milliseconds timeout );
+
+	const std::string	m_name;
+	int			m_fd;
+	void *			m_address;
+	size_t			m_size;
+	Header *		m_header;
+	size_t			m_slot_size;
+	size_t			m_slots_number;
+	uint64_t		m_stuck_position;
+	std::chrono::steady_clock::time_point	m_stuck_since;
+    };
+}
+
+#endif
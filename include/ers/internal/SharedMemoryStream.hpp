@@ -0,0 +1,83 @@
+/*
+ *  SharedMemoryStream.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file SharedMemoryStream.h This file defines SharedMemoryOutStream and SharedMemoryInStream ERS streams.
+  * \brief ers header file
+  */
+
+#ifndef ERS_SHARED_MEMORY_STREAM_H
+#define ERS_SHARED_MEMORY_STREAM_H
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include <ers/InputStream.hpp>
+#include <ers/OutputStream.hpp>
+#include <ers/internal/SharedMemoryQueue.hpp>
+
+namespace ers
+{
+    /** This stream passes issues to another process on the same node via a shared memory queue.
+     * In order to employ this implementation in a stream configuration the name to be used is "shm".
+     * E.g. the following configuration will send all errors to the "daq-node-logs" queue:
+     *
+     *         export DUNEDAQ_ERS_ERROR="shm(daq-node-logs)"
+     *
+     * This stream has the following configuration parameters:
+     *   - the name of the shared memory object
+     *   - the size of the queue, which may have k, M or G suffix. Default size is 16M.
+     *   - the maximum size of a serialized issue chain. Default value is 4k.
+     *   - the octal access mode of the shared memory object. Default value is 0600, i.e. only processes
+     *          of the same user can use the queue. Use 0660 to allow processes of the same group.
+     * The size parameters are only used by the process which creates the queue.
+     *
+     * The stream is thread-safe and never blocks, issues are dropped if the queue is full.
+     *
+     * \brief Shared memory output stream.
+     */
+    class SharedMemoryOutStream : public OutputStream
+    {
+      public:
+	explicit SharedMemoryOutStream( const std::string & format );
+
+	void write( const Issue & issue ) override;
+
+      private:
+	std::unique_ptr<SharedMemoryQueue>	m_queue;
+    };
+
+    /** This stream receives issues sent by the "shm" output streams of other processes. A queue
+     * may have only one reader, which can be created in the following way:
+     *
+     *         ers::StreamManager::instance().add_receiver( "shm", { "daq-node-logs" }, receiver );
+     *
+     * The parameters are the same as for the output stream. The receiver is called by a dedicated thread.
+     *
+     * \brief Shared memory input stream.
+     */
+    class SharedMemoryInStream : public InputStream
+    {
+      public:
+	explicit SharedMemoryInStream( const std::initializer_list<std::string> & params );
+
+	~SharedMemoryInStream();
+
+      protected:
+	void start() override;
+
+      private:
+	void run();
+
+	std::unique_ptr<SharedMemoryQueue>	m_queue;
+	std::atomic<bool>			m_terminated;
+	std::thread				m_thread;
+    };
+}
+
+#endif
@@ -10,8 +10,14 @@
 #ifndef ERS_THROTTLE_STREAM_H
 #define ERS_THROTTLE_STREAM_H
 
-#include <map>
+#include <stdint.h>
+
+#include <atomic>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include <ers/OutputStream.hpp>
 
@@ -23,10 +29,28 @@ namespace ers
      *
      *         export DUNEDAQ_ERS_FATAL="throttle(10, 20),stdout"
      *
-     * This stream has two configuration parameters:
+     * This stream has four configuration parameters:
      *   - first parameter defines an initial number of identical messages after which the throttling shall be started
      *   - second parameter defines a timeout in seconds after which the throttling is reset to its initial state if no
      *          issues of a given type have been reported in this period
+     *   - third parameter defines the maximum number of distinct issues which are tracked, the default is 10000.
+     *          If this number is exceeded the least recently reported issue is forgotten.
+     *   - fourth parameter defines which issues are considered identical:
+     *          - "site" - issues reported at the same line of the same file, this is the default
+     *          - "class" - issues of the same class reported at the same line of the same file
+     *          - "params:name1:name2..." - issues reported at the same line of the same file
+     *                  which have the same values of the given parameters
+     *          - "fingerprint" - issues of the same class reported at the same line of the same file
+     *                  which have the same values of all parameters
+     *
+     * E.g. the following configuration throttles issues separately for every value of the "link_id" parameter:
+     *
+     *         export DUNEDAQ_ERS_WARNING="throttle(10, 20, 10000, params:link_id),lstderr"
+     *
+     * Issues are identified by a hash of the fields which define the identity. The state of the issues
+     * is split into independently locked shards, so the threads reporting different issues rarely contend.
+     * The issues which have not been reported for longer than the timeout are forgotten as well. If a forgotten
+     * issue had some occurrences suppressed, a final suppression notice is sent for it, so no information is lost.
      *
      * \author Serguei Kolos
      * \brief Throws issues as exceptions
@@ -38,30 +62,64 @@ namespace ers
         void write(const ers::Issue &issue) override;
 
     private:
-        class IssueRecord {
-        public:
+        struct IssueRecord {
             IssueRecord();
             void reset();
 
-            std::time_t m_lastOccurance;
+            system_clock::time_point m_lastOccurance;
             std::time_t m_lastReport;
-            std::string m_lastOccuranceFormatted;
             int m_initialCounter;
             int m_threshold;
             int m_suppressedCounter;
+            std::unique_ptr<ers::Issue> m_suppressedIssue;	/**< \brief first suppressed issue, used for the final notice */
+            std::list<uint64_t>::iterator m_lruPosition;
+        };
+
+        /** Suppression notice of a record which has been forgotten */
+        struct Notice {
+            int m_suppressed;
+            system_clock::time_point m_lastOccurance;
+            std::unique_ptr<ers::Issue> m_issue;
+        };
+
+        /** Result of the throttling of a single issue */
+        struct Decision {
+            enum Action { Suppress, Pass, Notify };
+
+            Action m_action;
+            int m_suppressed;				/**< \brief number of suppressed issues for the Notify action */
+            system_clock::time_point m_lastOccurance;	/**< \brief time of the last suppressed issue */
+        };
+
+        static const size_t ShardsNumber = 16;
+
+        struct alignas(64) Shard {
+            std::mutex m_mutex;
+            std::unordered_map<uint64_t, IssueRecord> m_records;
+            std::list<uint64_t> m_lru;			/**< \brief the most recently reported issue goes first */
         };
 
+        enum KeyType { Site, SiteClass, SiteParameters, Fingerprint };
+
     private:
-        void throttle(IssueRecord &record, const ers::Issue &issue);
+        uint64_t issueKey(const ers::Issue &issue) const;
+
+        Decision throttle(IssueRecord &record, const ers::Issue &issue);
+
+        void reportSuppression(int suppressed, const system_clock::time_point &lastOccurance, const ers::Issue &issue);
+
+        void expire(Shard &shard, std::time_t now, std::vector<Notice> &notices);
 
-        void reportSuppression(IssueRecord &record, const ers::Issue &issue);
+        void forget(Shard &shard, std::unordered_map<uint64_t, IssueRecord>::iterator it, std::vector<Notice> &notices);
 
-        typedef std::map<std::string, IssueRecord> IssueMap;
-        IssueMap m_issueMap;
+        Shard m_shards[ShardsNumber];
+        size_t m_maxRecords;			/**< \brief maximum number of records per shard */
+        std::atomic<std::time_t> m_nextSweep;
 
         int m_initialThreshold;
         int m_timeLimit;
-        std::mutex m_mutex;
+        KeyType m_keyType;
+        std::vector<std::string> m_keyParameters;
     };
 }
 
@@ -24,9 +24,19 @@ namespace ers
     			const std::string & separators,
                         std::vector<std::string> & tokens );
     
+    //! same as tokenize, but also removes leading and trailing white space from every token
+    void tokenize_trimmed(	const std::string & text,
+				const std::string & separators,
+				std::vector<std::string> & tokens );
+    
     int read_from_environment( const char * name, int default_value );
     
     const char * read_from_environment( const char * name, const char * default_value );
+
+    size_t parse_size( const std::string & text, size_t default_value );
+
+    //! returns false if the text is not a number with an optional k, M or G suffix
+    bool try_parse_size( const std::string & text, size_t & value );
 }
 
 #endif
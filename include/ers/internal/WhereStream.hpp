@@ -0,0 +1,114 @@
+/*
+ *  WhereStream.h
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file WhereStream.h This file defines WhereStream ERS stream.
+  * \brief ers header file
+  */
+
+#ifndef ERS_WHERE_STREAM_H
+#define ERS_WHERE_STREAM_H
+
+#include <stdint.h>
+
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/regex.hpp>
+
+#include <ers/OutputStream.hpp>
+
+namespace ers
+{
+    /** This stream passes to the next stream in the chain only the issues, which satisfy the given
+     * expression. In order to employ this implementation in a stream configuration the name to be
+     * used is "where". E.g. the following configuration will print to the standard error only those
+     * errors, which are file related issues or have been reported for the link number 3:
+     *
+     *         export DUNEDAQ_ERS_ERROR="where(class~ers::File || param.link==3),lstderr"
+     *
+     * An expression is a combination of comparisons with the &&, || and ! operators and brackets.
+     * Each comparison consists of a field name, an operator (==, !=, <, <=, >, >= or ~) and a value,
+     * which may be quoted with single or double quotes. The following fields are supported:
+     *   - severity - the severity of the issue, compared by rank with DEBUG, LOG, INFO, WARNING, ERROR or FATAL
+     *   - class - the issue class name, class~name is true if the issue class is or inherits from the given one
+     *   - package, function, file, host, app, message - the corresponding attributes of the issue,
+     *          the function name is used without arguments
+     *   - line - the line number
+     *   - qualifier - true if any of the issue qualifiers satisfies the comparison
+     *   - param.<name> - the value of the given issue parameter, which is compared numerically
+     *          if the value in the expression is a number. Comparisons with missing parameters are false.
+     *
+     * For all fields except class the ~ operator searches the attribute for the given regular expression.
+     * The expression is parsed once into a compact code, which is evaluated without memory allocations.
+     * The stream is thread-safe.
+     *
+     * \brief Predicate filtering stream.
+     */
+    class WhereStream : public OutputStream
+    {
+      public:
+	explicit WhereStream( const std::string & expression );
+
+	void write( const Issue & issue ) override;
+
+      private:
+	enum Field : uint8_t
+	{
+	    Severity, Class, Package, Function, File, Line, Host, Application, Message, Qualifier, Parameter
+	};
+
+	enum Comparison : uint8_t
+	{
+	    Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual, Match
+	};
+
+	struct Predicate
+	{
+	    Field		m_field;
+	    Comparison		m_comparison;
+	    std::string		m_name;		/**< \brief parameter name */
+	    std::string		m_text;
+	    double		m_number = 0;
+	    bool		m_numeric = false;
+	    boost::regex	m_regex;
+	};
+
+	enum OpCode : uint8_t
+	{
+	    Test, Not, JumpIfFalse, JumpIfTrue
+	};
+
+	struct Instruction
+	{
+	    OpCode		m_code;
+	    uint32_t		m_argument;	/**< \brief predicate index or jump target */
+	};
+
+	struct Parser;
+
+	bool evaluate( const Issue & issue );
+
+	bool test( const Predicate & predicate, const Issue & issue );
+
+	bool inherits( const Predicate & predicate, const Issue & issue );
+
+	static bool compare( int order, Comparison comparison );
+
+	static bool test( const Predicate & predicate, const char * text, size_t length );
+
+	std::vector<Predicate>			m_predicates;
+	std::vector<Instruction>		m_code;
+
+	std::shared_mutex			m_mutex;
+	std::unordered_map<uint64_t, bool>	m_inheritance;	/**< \brief results of class~name tests */
+    };
+}
+
+#endif
@@ -0,0 +1,151 @@
+/*
+ *  AggregateStream.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include <ers/ers.hpp>
+#include <ers/internal/AggregateStream.hpp>
+#include <ers/internal/ExitHandlers.hpp>
+#include <ers/internal/Hash.hpp>
+#include <ers/internal/Util.hpp>
+#include <ers/internal/macro.hpp>
+
+ERS_DECLARE_ISSUE( ers,
+		   IssuesAggregated,
+		   count << " more issue(s) of the same kind have been reported in the last "
+			 << window << " second(s)" << statistics,
+		   ((uint64_t)count )
+		   ((unsigned int)window )
+		   ((std::string)statistics ) )
+
+ERS_REGISTER_OUTPUT_STREAM( ers::AggregateStream, "aggregate", format )
+
+ers::AggregateStream::AggregateStream( const std::string & format )
+  : m_window( 10 ),
+    m_terminated( false )
+{
+    std::vector<std::string> params;
+    ers::tokenize_trimmed( format, ",", params );
+
+    if ( params.size() > 0 )
+    {
+	std::istringstream in( params[0] );
+	int window = 10;
+	in >> window;
+	m_window = std::chrono::seconds( std::max( window, 1 ) );
+    }
+
+    if ( params.size() > 1 )
+    {
+	ers::tokenize_trimmed( params[1], ":", m_parameters );
+    }
+
+    m_thread = std::thread( &ers::AggregateStream::run, this );
+
+    ers::ExitHandlers::add( this, [this]() { flush(); } );
+}
+
+ers::AggregateStream::~AggregateStream()
+{
+    ers::ExitHandlers::remove( this );
+    {
+	std::scoped_lock lock( m_flush_mutex );
+	m_terminated = true;
+    }
+    m_condition.notify_one();
+    m_thread.join();
+    flush();
+}
+
+void
+ers::AggregateStream::write( const Issue & issue )
+{
+    const Context & context = issue.context();
+    uint64_t key = ers::hash_combine( ers::hash( context.file_name() ), context.line_number() );
+    key = ers::hash( issue.get_class_name(), ers::hash_combine( key, issue.severity().type ) );
+
+    {
+	std::scoped_lock lock( m_mutex );
+	auto it = m_entries.try_emplace( key );
+	if ( !it.second )
+	{
+	    // this kind of issue has been already passed in the current window
+	    Entry & e = it.first->second;
+	    if ( !e.m_count++ )
+	    {
+		e.m_first.reset( issue.clone() );
+		e.m_statistics.resize( m_parameters.size() );
+	    }
+
+	    for ( size_t i = 0; i < m_parameters.size(); ++i )
+	    {
+		auto p = issue.parameters().find( m_parameters[i] );
+		if ( p == issue.parameters().end() )
+		    continue;
+
+		char * end;
+		double value = ::strtod( p->second.c_str(), &end );
+		if ( end == p->second.c_str() )
+		    continue;
+
+		Statistics & s = e.m_statistics[i];
+		s.m_min = s.m_valid ? std::min( s.m_min, value ) : value;
+		s.m_max = s.m_valid ? std::max( s.m_max, value ) : value;
+		s.m_last = value;
+		s.m_valid = true;
+	    }
+	    return;
+	}
+    }
+
+    chained().write( issue );
+}
+
+void
+ers::AggregateStream::run()
+{
+    std::unique_lock lock( m_flush_mutex );
+    while ( !m_condition.wait_for( lock, m_window, [this]() { return m_terminated; } ) )
+    {
+	lock.unlock();
+	flush();
+	lock.lock();
+    }
+}
+
+void
+ers::AggregateStream::flush()
+{
+    Entries entries;
+    {
+	std::scoped_lock lock( m_mutex );
+	entries.swap( m_entries );
+    }
+
+    for ( auto & e : entries )
+    {
+	Entry & entry = e.second;
+	if ( !entry.m_count )
+	    continue;
+
+	std::ostringstream out;
+	for ( size_t i = 0; i < entry.m_statistics.size(); ++i )
+	{
+	    const Statistics & s = entry.m_statistics[i];
+	    if ( s.m_valid )
+		out << "; " << m_parameters[i] << ": min=" << s.m_min << " max=" << s.m_max << " last=" << s.m_last;
+	}
+
+	ers::IssuesAggregated issue( ERS_HERE, entry.m_count, m_window.count(), out.str(), *entry.m_first );
+	issue.set_severity( entry.m_first->severity() );
+	chained().write( issue );
+    }
+}
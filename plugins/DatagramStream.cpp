@@ -0,0 +1,437 @@
+/*
+ *  DatagramStream.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <errno.h>
+#include <netdb.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include <algorithm>
+#include <cstddef>
+
+#include <google/protobuf/io/coded_stream.h>
+
+#include <ers/SampleIssues.hpp>
+#include <ers/Schema.hpp>
+#include <ers/internal/DatagramStream.hpp>
+#include <ers/internal/ExitHandlers.hpp>
+#include <ers/internal/Util.hpp>
+#include <ers/internal/macro.hpp>
+
+namespace
+{
+    using google::protobuf::io::CodedInputStream;
+    using google::protobuf::io::CodedOutputStream;
+
+    const std::chrono::milliseconds FlushInterval( 10 );
+    const std::chrono::milliseconds RetryInterval( 1 );
+    const size_t MaxRetries = 10;
+    const std::chrono::seconds ReportInterval( 10 );
+    const std::chrono::milliseconds ReceiveTimeout( 100 );
+    const size_t MinDatagramSize = 512;
+    const size_t MaxDatagramSize = 65507;
+    const size_t ReceiveBatch = 16;
+
+    struct UdpOutStream : public ers::DatagramOutStream
+    {
+	explicit UdpOutStream( const std::string & format )
+	  : DatagramOutStream( AF_INET, format )
+	{ ; }
+    };
+
+    struct UnixOutStream : public ers::DatagramOutStream
+    {
+	explicit UnixOutStream( const std::string & format )
+	  : DatagramOutStream( AF_UNIX, format )
+	{ ; }
+    };
+
+    struct UdpInStream : public ers::DatagramInStream
+    {
+	explicit UdpInStream( const std::initializer_list<std::string> & params )
+	  : DatagramInStream( AF_INET, params )
+	{ ; }
+    };
+
+    struct UnixInStream : public ers::DatagramInStream
+    {
+	explicit UnixInStream( const std::initializer_list<std::string> & params )
+	  : DatagramInStream( AF_UNIX, params )
+	{ ; }
+    };
+
+    // the causes are dropped first and then the message is truncated if the chain is too long
+    size_t fit( dunedaq::ersschema::IssueChain & chain, size_t capacity )
+    {
+	size_t size = chain.ByteSizeLong();
+	if ( size > capacity && chain.causes_size() )
+	{
+	    chain.clear_causes();
+	    size = chain.ByteSizeLong();
+	}
+	if ( size > capacity )
+	{
+	    std::string & message = *chain.mutable_final()->mutable_message();
+	    message.resize( message.size() - std::min( message.size(), size - capacity ) );
+	    size = chain.ByteSizeLong();
+	}
+	return size;
+    }
+}
+
+ERS_REGISTER_OUTPUT_STREAM( UdpOutStream, "udp", format )
+
+ERS_REGISTER_OUTPUT_STREAM( UnixOutStream, "unix", format )
+
+ERS_REGISTER_INPUT_STREAM( UdpInStream, "udp", params )
+
+ERS_REGISTER_INPUT_STREAM( UnixInStream, "unix", params )
+
+ers::DatagramAddress::DatagramAddress( int family, const std::string & address, bool local )
+  : m_name( address ),
+    m_length( 0 ),
+    m_family( family )
+{
+    ::memset( &m_address, 0, sizeof( m_address ) );
+
+    if ( family == AF_UNIX )
+    {
+	sockaddr_un * a = reinterpret_cast<sockaddr_un *>( &m_address );
+	if ( address.empty() || address.size() >= sizeof( a->sun_path ) )
+	{
+	    throw ers::CantOpenFile( ERS_HERE, address.c_str() );
+	}
+	a->sun_family = AF_UNIX;
+	::memcpy( a->sun_path, address.data(), address.size() );
+	bool abstract = address[0] == '@';
+	if ( abstract )
+	    a->sun_path[0] = '\0';
+	m_length = offsetof( sockaddr_un, sun_path ) + address.size() + ( abstract ? 0 : 1 );
+	return;
+    }
+
+    std::string::size_type pos = address.rfind( ':' );
+    std::string host = pos == std::string::npos ? "" : address.substr( 0, pos );
+    std::string port = pos == std::string::npos ? address : address.substr( pos + 1 );
+    if ( host.size() > 1 && host.front() == '[' && host.back() == ']' )
+	host = host.substr( 1, host.size() - 2 );
+
+    addrinfo hints;
+    ::memset( &hints, 0, sizeof( hints ) );
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = local ? AI_PASSIVE : 0;
+
+    addrinfo * result = 0;
+    if ( port.empty() || ::getaddrinfo( host.empty() ? 0 : host.c_str(), port.c_str(), &hints, &result ) )
+    {
+	throw ers::CantOpenFile( ERS_HERE, address.c_str() );
+    }
+    ::memcpy( &m_address, result->ai_addr, result->ai_addrlen );
+    m_length = result->ai_addrlen;
+    m_family = result->ai_family;
+    ::freeaddrinfo( result );
+}
+
+ers::DatagramOutStream::DatagramOutStream( int family, const std::string & format )
+  : m_address( family, format.substr( 0, format.find( ',' ) ), false ),
+    m_datagram_size( DefaultDatagramSize ),
+    m_socket( -1 ),
+    m_dropped( 0 ),
+    m_terminated( false ),
+    m_reported( 0 )
+{
+    std::vector<std::string> params;
+    ers::tokenize( format, ",", params );
+    if ( params.size() > 1 )
+    {
+	m_datagram_size = std::clamp( ers::parse_size( params[1], DefaultDatagramSize ), MinDatagramSize, MaxDatagramSize );
+    }
+
+    m_socket = ::socket( m_address.m_family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0 );
+    if ( m_socket < 0 )
+    {
+	throw ers::CantOpenFile( ERS_HERE, m_address.m_name.c_str() );
+    }
+
+    m_current.m_data.reserve( m_datagram_size );
+    m_ready.reserve( MaxPendingDatagrams );
+    m_sending.reserve( MaxPendingDatagrams + 1 );
+    m_thread = std::thread( &ers::DatagramOutStream::run, this );
+
+    ers::ExitHandlers::add( this, [this]() { flush(); report_dropped( true ); } );
+}
+
+ers::DatagramOutStream::~DatagramOutStream()
+{
+    ers::ExitHandlers::remove( this );
+    {
+	std::scoped_lock lock( m_mutex );
+	m_terminated = true;
+    }
+    m_condition.notify_one();
+    m_thread.join();
+    flush();
+    report_dropped( true );
+    ::close( m_socket );
+}
+
+void
+ers::DatagramOutStream::write( const Issue & issue )
+{
+    dunedaq::ersschema::IssueChain chain;
+    to_schema( issue, chain );
+    size_t size = fit( chain, m_datagram_size - CodedOutputStream::VarintSize32( m_datagram_size ) );
+    size_t length = CodedOutputStream::VarintSize32( size ) + size;
+
+    bool notify = false;
+    {
+	std::scoped_lock lock( m_mutex );
+	bool full = m_current.m_data.size() + length > m_datagram_size;
+	if ( full && m_ready.size() == MaxPendingDatagrams )
+	{
+	    // the issue is dropped, but it is still passed to the next stream outside of the lock
+	    ++m_dropped;
+	}
+	else
+	{
+	    if ( full )
+	    {
+		m_ready.push_back( std::move( m_current ) );
+		m_current = take_free();
+		notify = true;
+	    }
+
+	    size_t offset = m_current.m_data.size();
+	    m_current.m_data.resize( offset + length );
+	    uint8_t * data = reinterpret_cast<uint8_t *>( &m_current.m_data[offset] );
+	    data = CodedOutputStream::WriteVarint32ToArray( size, data );
+	    chain.SerializeWithCachedSizesToArray( data );
+	    if ( !m_current.m_issues++ )
+		notify = true;
+	}
+    }
+
+    if ( notify )
+	m_condition.notify_one();
+
+    chained().write( issue );
+}
+
+ers::DatagramOutStream::Datagram
+ers::DatagramOutStream::take_free()
+{
+    if ( m_free.empty() )
+    {
+	Datagram d;
+	d.m_data.reserve( m_datagram_size );
+	return d;
+    }
+    Datagram d = std::move( m_free.back() );
+    m_free.pop_back();
+    return d;
+}
+
+void
+ers::DatagramOutStream::run()
+{
+    std::unique_lock lock( m_mutex );
+    while ( !m_terminated )
+    {
+	m_condition.wait( lock, [this]() { return m_current.m_issues || !m_ready.empty() || m_terminated; } );
+
+	// let more issues join the current datagram, unless there are full ones already
+	m_condition.wait_for( lock, FlushInterval, [this]() { return !m_ready.empty() || m_terminated; } );
+
+	lock.unlock();
+	flush();
+	report_dropped( false );
+	lock.lock();
+    }
+}
+
+void
+ers::DatagramOutStream::flush()
+{
+    std::scoped_lock flush_lock( m_flush_mutex );
+    {
+	std::scoped_lock lock( m_mutex );
+	for ( Datagram & d : m_ready )
+	    m_sending.push_back( std::move( d ) );
+	m_ready.clear();
+	if ( m_current.m_issues )
+	{
+	    m_sending.push_back( std::move( m_current ) );
+	    m_current = take_free();
+	}
+    }
+
+    if ( m_sending.empty() )
+	return;
+
+    send( m_sending );
+
+    std::scoped_lock lock( m_mutex );
+    for ( Datagram & d : m_sending )
+    {
+	d.m_data.clear();
+	d.m_issues = 0;
+	m_free.push_back( std::move( d ) );
+    }
+    m_sending.clear();
+}
+
+void
+ers::DatagramOutStream::send( std::vector<Datagram> & datagrams )
+{
+    mmsghdr messages[MaxPendingDatagrams + 1];
+    iovec vectors[MaxPendingDatagrams + 1];
+    size_t n = datagrams.size();
+
+    for ( size_t i = 0; i < n; ++i )
+    {
+	vectors[i].iov_base = &datagrams[i].m_data[0];
+	vectors[i].iov_len = datagrams[i].m_data.size();
+	::memset( &messages[i], 0, sizeof( messages[i] ) );
+	messages[i].msg_hdr.msg_name = &m_address.m_address;
+	messages[i].msg_hdr.msg_namelen = m_address.m_length;
+	messages[i].msg_hdr.msg_iov = &vectors[i];
+	messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    size_t sent = 0;
+    size_t retries = 0;
+    while ( sent < n )
+    {
+	int r = ::sendmmsg( m_socket, messages + sent, n - sent, MSG_DONTWAIT );
+	if ( r < 0 && errno == EINTR )
+	    continue;
+
+	// the receiver may be slower than a burst of issues, which happens in particular with the Unix
+	// domain sockets which have very short queues, so this thread waits a bit before giving up
+	if ( r < 0 && ( errno == EAGAIN || errno == ENOBUFS ) && retries++ < MaxRetries )
+	{
+	    std::this_thread::sleep_for( RetryInterval );
+	    continue;
+	}
+
+	if ( r <= 0 )
+	{
+	    // the socket buffer is full or there is no receiver, the remaining datagrams are lost
+	    for ( size_t i = sent; i < n; ++i )
+		m_dropped += datagrams[i].m_issues;
+	    break;
+	}
+	sent += r;
+	retries = 0;
+    }
+}
+
+void
+ers::DatagramOutStream::report_dropped( bool force )
+{
+    std::scoped_lock lock( m_flush_mutex );
+    uint64_t dropped = m_dropped;
+    auto now = std::chrono::steady_clock::now();
+    if ( dropped != m_reported && ( force || now - m_last_report >= ReportInterval ) )
+    {
+	ERS_INTERNAL_WARNING( "\"" << m_address.m_name << "\" datagram stream has dropped "
+	    << dropped - m_reported << " issue(s)" );
+	m_reported = dropped;
+	m_last_report = now;
+    }
+}
+
+ers::DatagramInStream::DatagramInStream( int family, const std::initializer_list<std::string> & params )
+  : m_address( family, params.size() ? *params.begin() : "", true ),
+    m_socket( ::socket( m_address.m_family, SOCK_DGRAM | SOCK_CLOEXEC, 0 ) ),
+    m_terminated( false )
+{
+    if ( m_socket < 0 )
+    {
+	throw ers::CantOpenFile( ERS_HERE, m_address.m_name.c_str() );
+    }
+
+    struct stat st;
+    if (    m_address.m_family == AF_UNIX && m_address.m_name[0] != '@'
+	 && !::stat( m_address.m_name.c_str(), &st ) && S_ISSOCK( st.st_mode ) )
+    {
+	::unlink( m_address.m_name.c_str() );
+    }
+
+    timeval timeout = { 0, (suseconds_t)std::chrono::microseconds( ReceiveTimeout ).count() };
+    ::setsockopt( m_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof( timeout ) );
+    int buffer_size = 4 << 20;
+    ::setsockopt( m_socket, SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof( buffer_size ) );
+
+    if ( ::bind( m_socket, reinterpret_cast<const sockaddr *>( &m_address.m_address ), m_address.m_length ) )
+    {
+	::close( m_socket );
+	throw ers::CantOpenFile( ERS_HERE, m_address.m_name.c_str() );
+    }
+}
+
+ers::DatagramInStream::~DatagramInStream()
+{
+    m_terminated = true;
+    if ( m_thread.joinable() )
+	m_thread.join();
+    ::close( m_socket );
+    if ( m_address.m_family == AF_UNIX && m_address.m_name[0] != '@' )
+	::unlink( m_address.m_name.c_str() );
+}
+
+void
+ers::DatagramInStream::start()
+{
+    if ( !m_thread.joinable() )
+	m_thread = std::thread( &ers::DatagramInStream::run, this );
+}
+
+void
+ers::DatagramInStream::run()
+{
+    std::vector<char> buffer( ReceiveBatch * MaxDatagramSize );
+    mmsghdr messages[ReceiveBatch];
+    iovec vectors[ReceiveBatch];
+
+    while ( !m_terminated )
+    {
+	for ( size_t i = 0; i < ReceiveBatch; ++i )
+	{
+	    vectors[i].iov_base = &buffer[i * MaxDatagramSize];
+	    vectors[i].iov_len = MaxDatagramSize;
+	    ::memset( &messages[i], 0, sizeof( messages[i] ) );
+	    messages[i].msg_hdr.msg_iov = &vectors[i];
+	    messages[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	int n = ::recvmmsg( m_socket, messages, ReceiveBatch, MSG_WAITFORONE, 0 );
+	for ( int i = 0; i < n; ++i )
+	{
+	    CodedInputStream input( reinterpret_cast<const uint8_t *>( vectors[i].iov_base ), messages[i].msg_len );
+	    uint32_t size;
+	    const void * data;
+	    int available;
+	    while (    input.ReadVarint32( &size )
+		    && input.GetDirectBufferPointer( &data, &available )
+		    && (uint32_t)available >= size )
+	    {
+		dunedaq::ersschema::IssueChain chain;
+		if ( chain.ParseFromArray( data, size ) )
+		{
+		    std::unique_ptr<Issue> issue = ers::from_schema( chain );
+		    receive( *issue );
+		}
+		input.Skip( size );
+	    }
+	}
+    }
+}
@@ -0,0 +1,204 @@
+/*
+ *  JournalStream.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <cctype>
+#include <chrono>
+
+#include <ers/SampleIssues.hpp>
+#include <ers/internal/JournalStream.hpp>
+#include <ers/internal/macro.hpp>
+
+ERS_REGISTER_OUTPUT_STREAM( ers::JournalStream, "journal", socket_path )
+
+namespace
+{
+    const char * const DefaultSocketPath = "/run/systemd/journal/socket";
+    const size_t MaxFieldNameLength = 64;
+
+    // syslog priorities of the ERS severities
+    const char * const Priorities[] = { "7", "6", "6", "4", "3", "2" };
+
+    void add_field( std::string & data, const std::string & name, const char * value, size_t size )
+    {
+	if ( ::memchr( value, '\n', size ) )
+	{
+	    // a multi-line value is given in binary form with its little endian 64 bit length
+	    data.append( name ).push_back( '\n' );
+	    for ( int i = 0; i < 8; ++i )
+		data.push_back( (char)( (uint64_t)size >> ( 8 * i ) ) );
+	}
+	else
+	{
+	    data.append( name ).push_back( '=' );
+	}
+	data.append( value, size ).push_back( '\n' );
+    }
+
+    void add_field( std::string & data, const std::string & name, const std::string & value )
+    {
+	add_field( data, name, value.data(), value.size() );
+    }
+
+    void add_field( std::string & data, const std::string & name, const char * value )
+    {
+	add_field( data, name, value, ::strlen( value ) );
+    }
+
+    template <class T>
+    void add_field( std::string & data, const std::string & name, T value )
+    {
+	add_field( data, name, std::to_string( value ) );
+    }
+
+    // journal field names may only contain upper case letters, digits and underscores
+    std::string field_name( const char * prefix, const std::string & name )
+    {
+	std::string result( prefix );
+	for ( char c : name )
+	{
+	    if ( result.size() == MaxFieldNameLength )
+		break;
+	    result.push_back( std::isalnum( (unsigned char)c ) ? std::toupper( (unsigned char)c ) : '_' );
+	}
+	return result;
+    }
+}
+
+ers::JournalStream::JournalStream( const std::string & socket_path )
+  : m_path( socket_path.empty() ? DefaultSocketPath : socket_path ),
+    m_socket( ::socket( AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0 ) ),
+    m_failed( false )
+{
+    ::memset( &m_address, 0, sizeof( m_address ) );
+    if ( m_socket < 0 || m_path.size() >= sizeof( m_address.sun_path ) )
+    {
+	throw ers::CantOpenFile( ERS_HERE, m_path.c_str() );
+    }
+    m_address.sun_family = AF_UNIX;
+    ::memcpy( m_address.sun_path, m_path.c_str(), m_path.size() + 1 );
+    m_length = offsetof( sockaddr_un, sun_path ) + m_path.size() + 1;
+
+    // the journal daemon accepts the datagrams of up to 8M
+    int buffer_size = 8 << 20;
+    ::setsockopt( m_socket, SOL_SOCKET, SO_SNDBUF, &buffer_size, sizeof( buffer_size ) );
+}
+
+ers::JournalStream::~JournalStream()
+{
+    ::close( m_socket );
+}
+
+void
+ers::JournalStream::write( const Issue & issue )
+{
+    const Context & context = issue.context();
+    std::string data;
+    data.reserve( 1024 );
+
+    add_field( data, "MESSAGE", issue.message() );
+    add_field( data, "PRIORITY", Priorities[issue.severity().type] );
+    add_field( data, "CODE_FILE", context.file_name() );
+    add_field( data, "CODE_LINE", context.line_number() );
+    add_field( data, "CODE_FUNC", context.function_name() );
+    add_field( data, "SYSLOG_IDENTIFIER", context.application_name() );
+
+    add_field( data, "ERS_CLASS", issue.get_class_name() );
+    add_field( data, "ERS_SEVERITY", ers::to_string( issue.severity() ) );
+    add_field( data, "ERS_PACKAGE", context.package_name() );
+    add_field( data, "ERS_HOST", context.host_name() );
+    add_field( data, "ERS_PID", context.process_id() );
+    add_field( data, "ERS_TID", context.thread_id() );
+    add_field( data, "ERS_USER", context.user_name() );
+    add_field( data, "ERS_CWD", context.cwd() );
+    add_field( data, "ERS_TIME_USEC", (long long)std::chrono::duration_cast<std::chrono::microseconds>(
+		issue.ptime().time_since_epoch() ).count() );
+
+    for ( const std::string & q : issue.qualifiers() )
+	add_field( data, "ERS_QUALIFIER", q );
+
+    for ( const auto & p : issue.parameters() )
+	add_field( data, field_name( "ERS_PARAM_", p.first ), p.second );
+
+    for ( const Issue * cause = issue.cause(); cause; cause = cause->cause() )
+	add_field( data, "ERS_CAUSE", std::string( cause->get_class_name() ) + ": " + cause->message() );
+
+    ssize_t r;
+    do
+    {
+	r = ::sendto( m_socket, data.data(), data.size(), MSG_NOSIGNAL,
+		      reinterpret_cast<const sockaddr *>( &m_address ), m_length );
+    }
+    while ( r < 0 && errno == EINTR );
+
+    bool sent = r >= 0 || ( ( errno == EMSGSIZE || errno == ENOBUFS ) && send_memfd( data ) );
+
+    // the failure is reported once, until the journal becomes available again
+    if ( !sent && !m_failed.exchange( true ) )
+    {
+	ERS_INTERNAL_ERROR( "Can not send issue to the journal via \"" << m_path << "\": " << strerror( errno ) );
+    }
+    else if ( sent && m_failed )
+    {
+	m_failed = false;
+    }
+
+    chained().write( issue );
+}
+
+bool
+ers::JournalStream::send_memfd( const std::string & data )
+{
+    int fd = ::memfd_create( "ers-journal", MFD_ALLOW_SEALING | MFD_CLOEXEC );
+    if ( fd < 0 )
+	return false;
+
+    bool result = false;
+    if (    ::write( fd, data.data(), data.size() ) == (ssize_t)data.size()
+	 && !::fcntl( fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL ) )
+    {
+	// the journal daemon reads the whole record from the sealed file descriptor given with an empty datagram
+	union
+	{
+	    cmsghdr	header;
+	    char	buffer[CMSG_SPACE( sizeof( int ) )];
+	} control;
+	::memset( &control, 0, sizeof( control ) );
+
+	msghdr message;
+	::memset( &message, 0, sizeof( message ) );
+	message.msg_name = &m_address;
+	message.msg_namelen = m_length;
+	message.msg_control = &control;
+	message.msg_controllen = sizeof( control );
+
+	cmsghdr * c = CMSG_FIRSTHDR( &message );
+	c->cmsg_level = SOL_SOCKET;
+	c->cmsg_type = SCM_RIGHTS;
+	c->cmsg_len = CMSG_LEN( sizeof( int ) );
+	::memcpy( CMSG_DATA( c ), &fd, sizeof( int ) );
+
+	ssize_t r;
+	do
+	{
+	    r = ::sendmsg( m_socket, &message, MSG_NOSIGNAL );
+	}
+	while ( r < 0 && errno == EINTR );
+	result = r >= 0;
+    }
+
+    int error = errno;
+    ::close( fd );
+    errno = error;
+    return result;
+}
@@ -0,0 +1,50 @@
+/*
+ *  MMapRingStream.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <ers/internal/MMapRingStream.hpp>
+#include <ers/internal/Util.hpp>
+#include <ers/StreamFactory.hpp>
+
+ERS_DECLARE_ISSUE( ers,
+		   BadRingParameters,
+		   "Parameters \"" << format << "\" of the mmapring stream are invalid: " << reason,
+		   ((std::string)format )
+		   ((std::string)reason ) )
+
+ERS_REGISTER_OUTPUT_STREAM( ers::MMapRingStream, "mmapring", format )
+
+namespace
+{
+    const size_t DefaultSize = 16 << 20;
+}
+
+ers::MMapRingStream::MMapRingStream( const std::string & format )
+{
+    std::vector<std::string> params;
+    ers::tokenize_trimmed( format, ",", params );
+
+    if ( params[0].empty() )
+    {
+	throw ers::BadRingParameters( ERS_HERE, format, "the file name is not given" );
+    }
+
+    size_t size = DefaultSize;
+    if ( params.size() > 1 && !ers::try_parse_size( params[1], size ) )
+    {
+	throw ers::BadRingParameters( ERS_HERE, format, "\"" + params[1] + "\" is not a valid size" );
+    }
+
+    m_ring.reset( new MMapRing( params[0], size ) );
+}
+
+void
+ers::MMapRingStream::write( const Issue & issue )
+{
+    m_ring->write( issue );
+    chained().write( issue );
+}
@@ -0,0 +1,153 @@
+/*
+ *  ProtoFileStream.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <chrono>
+
+#include <ers/SampleIssues.hpp>
+#include <ers/Schema.hpp>
+#include <ers/StreamFactory.hpp>
+#include <ers/internal/ProtoFileStream.hpp>
+#include <ers/internal/macro.hpp>
+
+ERS_REGISTER_OUTPUT_STREAM( ers::ProtoFileOutStream, "protofile", file_name )
+
+ERS_REGISTER_INPUT_STREAM( ers::ProtoFileInStream, "protofile", params )
+
+namespace
+{
+    const std::chrono::milliseconds PollingInterval( 100 );
+    const size_t MaxVarintSize = 5;
+
+    size_t write_varint( uint32_t value, char * buffer )
+    {
+	size_t n = 0;
+	for ( ; value >= 0x80; value >>= 7 )
+	    buffer[n++] = (char)( value | 0x80 );
+	buffer[n++] = (char)value;
+	return n;
+    }
+
+    // returns the number of bytes taken by the varint or 0 if the data are incomplete
+    size_t read_varint( const char * buffer, size_t size, uint32_t & value )
+    {
+	value = 0;
+	for ( size_t i = 0; i < size && i < MaxVarintSize; ++i )
+	{
+	    value |= (uint32_t)( buffer[i] & 0x7f ) << ( 7 * i );
+	    if ( !( buffer[i] & 0x80 ) )
+		return i + 1;
+	}
+	return 0;
+    }
+}
+
+ers::ProtoFileOutStream::ProtoFileOutStream( const std::string & file_name )
+  : m_file_name( file_name ),
+    m_fd( ::open( file_name.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644 ) )
+{
+    if ( m_fd < 0 )
+    {
+	throw ers::CantOpenFile( ERS_HERE, file_name.c_str() );
+    }
+}
+
+ers::ProtoFileOutStream::~ProtoFileOutStream()
+{
+    ::close( m_fd );
+}
+
+void
+ers::ProtoFileOutStream::write( const Issue & issue )
+{
+    dunedaq::ersschema::IssueChain chain;
+    to_schema( issue, chain );
+
+    size_t size = chain.ByteSizeLong();
+    std::string buffer( MaxVarintSize + size, '\0' );
+    size_t n = write_varint( size, &buffer[0] );
+    chain.SerializeWithCachedSizesToArray( reinterpret_cast<uint8_t *>( &buffer[n] ) );
+
+    // a single write of the whole record keeps the records of different processes apart
+    if ( ::write( m_fd, buffer.data(), n + size ) != (ssize_t)( n + size ) )
+    {
+	ERS_INTERNAL_ERROR( "Can not write to the \"" << m_file_name << "\" file: " << ::strerror( errno ) )
+    }
+
+    chained().write( issue );
+}
+
+ers::ProtoFileInStream::ProtoFileInStream( const std::initializer_list<std::string> & params )
+  : m_file_name( params.size() ? *params.begin() : "" ),
+    m_fd( ::open( m_file_name.c_str(), O_RDONLY | O_CREAT | O_CLOEXEC, 0644 ) ),
+    m_terminated( false )
+{
+    if ( m_fd < 0 )
+    {
+	throw ers::CantOpenFile( ERS_HERE, m_file_name.c_str() );
+    }
+}
+
+ers::ProtoFileInStream::~ProtoFileInStream()
+{
+    m_terminated = true;
+    if ( m_thread.joinable() )
+	m_thread.join();
+    ::close( m_fd );
+}
+
+void
+ers::ProtoFileInStream::start()
+{
+    if ( !m_thread.joinable() )
+	m_thread = std::thread( &ers::ProtoFileInStream::run, this );
+}
+
+void
+ers::ProtoFileInStream::run()
+{
+    std::string data;
+    size_t offset = 0;
+    char buffer[1 << 16];
+
+    while ( !m_terminated )
+    {
+	ssize_t n = ::read( m_fd, buffer, sizeof( buffer ) );
+	if ( n < 0 && errno == EINTR )
+	    continue;
+	if ( n <= 0 )
+	{
+	    std::this_thread::sleep_for( PollingInterval );
+	    continue;
+	}
+	data.append( buffer, n );
+
+	while ( true )
+	{
+	    uint32_t size;
+	    size_t header = read_varint( data.data() + offset, data.size() - offset, size );
+	    if ( !header || data.size() - offset - header < size )
+		break;
+
+	    dunedaq::ersschema::IssueChain chain;
+	    if ( chain.ParseFromArray( data.data() + offset + header, size ) )
+	    {
+		std::unique_ptr<Issue> issue = from_schema( chain );
+		receive( *issue );
+	    }
+	    offset += header + size;
+	}
+
+	data.erase( 0, offset );
+	offset = 0;
+    }
+}
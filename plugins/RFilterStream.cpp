@@ -7,6 +7,9 @@
  *
  */
 
+#include <string.h>
+
+#include <ers/internal/Hash.hpp>
 #include <ers/internal/RFilterStream.hpp>
 #include <ers/internal/Util.hpp>
 #include <ers/StreamFactory.hpp>
@@ -28,66 +31,105 @@ namespace
   * \param format describes filter expression.
   */
 ers::RFilterStream::RFilterStream( const std::string & format )
+  : m_hasInclude( false ),
+    m_hasExclude( false )
 {
     std::vector<std::string> tokens;
     ers::tokenize( format, SEPARATORS, tokens );
+
+    std::string include, exclude;
     for( size_t i = 0; i < tokens.size(); i++ )
     {
-        if ( !tokens[i].empty() && tokens[i][0] == NOT ) 
-            m_regExclude.push_back( boost::regex(tokens[i].substr( 1 )) );
-        else
-            m_regInclude.push_back( boost::regex(tokens[i]) );
+        bool excluded = !tokens[i].empty() && tokens[i][0] == NOT;
+        std::string pattern = excluded ? tokens[i].substr( 1 ) : tokens[i];
+
+        // compile every expression separately to report errors for the original one
+        boost::regex( pattern.c_str() );
+
+        std::string & combined = excluded ? exclude : include;
+        combined += ( combined.empty() ? "(?:" : "|(?:" ) + pattern + ")";
+        ( excluded ? m_hasExclude : m_hasInclude ) = true;
     }
+
+    if ( m_hasInclude )
+        m_regInclude.assign( include );
+    if ( m_hasExclude )
+        m_regExclude.assign( exclude );
 }
 
 
-/** Filtering method 
-  * This method checks if an Issue is to be accepted or not. 
-  * \param issue_ptr the issue to check 
+/** Matching method
+  * This method matches the function name and the qualifiers of the issue with the
+  * exclude and include expressions.
+  * \param issue the issue to check
+  * \param function the function name without arguments
+  * \param length length of the function name
   * \return \c true if the Issue passes filtering, \c false otherwise.
   */
 bool
-ers::RFilterStream::is_accepted( const ers::Issue & issue )
+ers::RFilterStream::match( const ers::Issue & issue, const char * function, size_t length )
 {
-  // Get the function name that will be the input of the pattern search
-  std::string s = issue.context().function_name();
-  // Remove the function arguments, which could lead to fake matches
-  s = s.substr(0,s.find_first_of('('));   
-  
   const std::vector<std::string> & qualifiers = issue.qualifiers( );
-  std::vector<boost::regex>::const_iterator it;
 
-  // Check excluded matches 
-  for( it = m_regExclude.begin(); it != m_regExclude.end(); ++it )
+  // Check excluded matches (function name, then qualifiers)
+  if ( m_hasExclude )
   {
-    // 1. Check against function name
-    if (boost::regex_search(s, *it))
+    if ( boost::regex_search( function, function + length, m_regExclude ) )
       return false;
-    
-    // 2. Check against qualifiers
-    std::vector<std::string>::const_iterator ko;
-    for ( ko=qualifiers.begin(); ko<qualifiers.end(); ko++)
-      if ( boost::regex_search(*ko,*it) ) 
+
+    for ( const std::string & q : qualifiers )
+      if ( boost::regex_search( q, m_regExclude ) )
         return false;
   }
 
   // Check included matches (function name, then qualifiers)
-  for( it = m_regInclude.begin(); it != m_regInclude.end(); ++it )
+  if ( m_hasInclude )
   {
-    // 1. Check against function name
-    if (boost::regex_search(s, *it))
+    if ( boost::regex_search( function, function + length, m_regInclude ) )
       return true;
-   
-    // 2. Check against qualifiers
-    std::vector<std::string>::const_iterator ok;
-    for (ok=qualifiers.begin(); ok<qualifiers.end(); ok++)
-      if ( boost::regex_search(*ok,*it) )
+
+    for ( const std::string & q : qualifiers )
+      if ( boost::regex_search( q, m_regInclude ) )
         return true;
   }
 
   return false; //m_regInclude.empty();
 }
 
+/** Filtering method 
+  * This method checks if an Issue is to be accepted or not. The decisions are memoized
+  * for every combination of the function name and the qualifiers.
+  * \param issue_ptr the issue to check 
+  * \return \c true if the Issue passes filtering, \c false otherwise.
+  */
+bool
+ers::RFilterStream::is_accepted( const ers::Issue & issue )
+{
+  // Remove the function arguments, which could lead to fake matches
+  const char * function = issue.context().function_name();
+  size_t length = ::strcspn( function, "(" );
+
+  // the cast selects the byte sequence overload, otherwise the length would be taken as the seed
+  uint64_t key = ers::hash( static_cast<const void *>( function ), length );
+  for ( const std::string & q : issue.qualifiers() )
+    key = ers::hash( q, key );
+
+  {
+    std::shared_lock lock( m_mutex );
+    auto it = m_decisions.find( key );
+    if ( it != m_decisions.end() )
+      return it->second;
+  }
+
+  bool accepted = match( issue, function, length );
+
+  std::unique_lock lock( m_mutex );
+  if ( m_decisions.size() >= MaxDecisions )
+    m_decisions.clear();
+  m_decisions.emplace( key, accepted );
+  return accepted;
+}
+
 /** Write method 
   * basically calls \c is_accept to check if the issue is accepted. 
   * If this is the case, the \c write method on the chained stream is called with 
@@ -0,0 +1,217 @@
+/*
+ *  RateLimitStream.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <algorithm>
+#include <map>
+#include <shared_mutex>
+#include <sstream>
+#include <vector>
+
+#include <ers/ers.hpp>
+#include <ers/internal/ExitHandlers.hpp>
+#include <ers/internal/RateLimitStream.hpp>
+#include <ers/internal/Util.hpp>
+#include <ers/internal/macro.hpp>
+
+ERS_DECLARE_ISSUE( ers,
+		   IssuesDropped,
+		   count << " issue(s) have been dropped by the rate limiter",
+		   ((uint64_t)count ) )
+
+ERS_REGISTER_OUTPUT_STREAM( ers::RateLimitStream, "ratelimit", format )
+
+/** The bucket keeps the theoretical arrival time of the next issue, which is the time when the bucket
+  * gets one token. An issue is accepted if this time is not further than the burst size in the future.
+  */
+struct alignas( 64 ) ers::RateLimitStream::Bucket
+{
+    std::atomic<int64_t>	m_next{ 0 };
+};
+
+struct ers::RateLimitStream::Buckets
+{
+    /** Returns the buckets shared by all streams with the given key */
+    static std::shared_ptr<Buckets> get( const std::string & key )
+    {
+	static std::mutex * mutex = new std::mutex;
+	static auto * registry = new std::map<std::string, std::weak_ptr<Buckets> >;
+
+	std::scoped_lock lock( *mutex );
+	std::shared_ptr<Buckets> buckets = (*registry)[key].lock();
+	if ( !buckets )
+	{
+	    buckets = std::make_shared<Buckets>();
+	    (*registry)[key] = buckets;
+	}
+	return buckets;
+    }
+
+    /** Returns the bucket of the given package, which is created when it is used for the first time */
+    Bucket & package( const char * name )
+    {
+	{
+	    std::shared_lock lock( m_mutex );
+	    auto it = m_packages.find( name );
+	    if ( it != m_packages.end() )
+		return *it->second;
+	}
+
+	std::unique_lock lock( m_mutex );
+	std::unique_ptr<Bucket> & bucket = m_packages[name];
+	if ( !bucket )
+	    bucket.reset( new Bucket );
+	return *bucket;
+    }
+
+    Bucket	m_global;
+    std::shared_mutex	m_mutex;
+    std::map<std::string, std::unique_ptr<Bucket>, std::less<> >	m_packages;
+};
+
+ers::RateLimitStream::RateLimitStream( const std::string & format )
+  : m_per_severity( false ),
+    m_per_package( false ),
+    m_dropped( 0 ),
+    m_max_severity( ers::Debug ),
+    m_report_interval( 10 ),
+    m_terminated( false )
+{
+    std::vector<std::string> params;
+    ers::tokenize_trimmed( format, ",", params );
+
+    double rate = 100;
+    if ( params.size() > 0 )
+    {
+	std::istringstream in( params[0] );
+	in >> rate;
+    }
+    rate = std::max( rate, 1e-3 );
+
+    double burst = rate;
+    if ( params.size() > 1 )
+    {
+	std::istringstream in( params[1] );
+	in >> burst;
+    }
+    burst = std::max( burst, 1. );
+
+    if ( params.size() > 2 )
+    {
+	std::vector<std::string> key;
+	ers::tokenize_trimmed( params[2], ":", key );
+	for ( const std::string & k : key )
+	{
+	    if ( k == "severity" )
+		m_per_severity = true;
+	    else if ( k == "package" )
+		m_per_package = true;
+	    else if ( k != "global" )
+		ERS_INTERNAL_WARNING( "Unknown rate limiter key \"" << k << "\" is ignored" )
+	}
+    }
+
+    if ( params.size() > 3 )
+    {
+	std::istringstream in( params[3] );
+	int interval = 10;
+	in >> interval;
+	m_report_interval = std::chrono::seconds( std::max( interval, 1 ) );
+    }
+
+    m_period = (int64_t)( 1e9 / rate );
+
+    // lower severities can use a smaller part of the burst, the rest is reserved for the higher ones
+    int64_t tolerance = (int64_t)( ( burst - 1 ) * m_period );
+    for ( int s = ers::Debug; s < ers::Fatal; ++s )
+    {
+	m_tolerance[s] = m_per_severity ? tolerance * ( s + 1 ) / ers::Fatal : tolerance;
+    }
+
+    // the streams with the same budgets share the buckets regardless of how the parameters are written
+    std::ostringstream key;
+    key << m_period << ',' << tolerance << ',' << m_per_severity << ',' << m_per_package;
+    m_buckets = Buckets::get( key.str() );
+
+    m_thread = std::thread( &ers::RateLimitStream::run, this );
+
+    ers::ExitHandlers::add( this, [this]() { report(); } );
+}
+
+ers::RateLimitStream::~RateLimitStream()
+{
+    ers::ExitHandlers::remove( this );
+    {
+	std::scoped_lock lock( m_mutex );
+	m_terminated = true;
+    }
+    m_condition.notify_one();
+    m_thread.join();
+    report();
+}
+
+bool
+ers::RateLimitStream::acquire( Bucket & bucket, int64_t now, int64_t tolerance )
+{
+    int64_t next = bucket.m_next.load( std::memory_order_relaxed );
+    while ( true )
+    {
+	int64_t base = std::max( next, now );
+	if ( base - now > tolerance )
+	    return false;
+	if ( bucket.m_next.compare_exchange_weak( next, base + m_period, std::memory_order_relaxed ) )
+	    return true;
+    }
+}
+
+void
+ers::RateLimitStream::write( const Issue & issue )
+{
+    ers::severity severity = issue.severity().type;
+    if ( severity != ers::Fatal )
+    {
+	Bucket & bucket = m_per_package
+		? m_buckets->package( issue.context().package_name() ) : m_buckets->m_global;
+
+	int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch() ).count();
+	if ( !acquire( bucket, now, m_tolerance[severity] ) )
+	{
+	    int max = m_max_severity.load( std::memory_order_relaxed );
+	    while ( max < severity && !m_max_severity.compare_exchange_weak( max, severity, std::memory_order_relaxed ) )
+		;
+	    m_dropped.fetch_add( 1, std::memory_order_relaxed );
+	    return;
+	}
+    }
+
+    chained().write( issue );
+}
+
+void
+ers::RateLimitStream::run()
+{
+    std::unique_lock lock( m_mutex );
+    while ( !m_condition.wait_for( lock, m_report_interval, [this]() { return m_terminated; } ) )
+    {
+	lock.unlock();
+	report();
+	lock.lock();
+    }
+}
+
+void
+ers::RateLimitStream::report()
+{
+    uint64_t dropped = m_dropped.exchange( 0, std::memory_order_relaxed );
+    if ( !dropped )
+	return;
+
+    ers::IssuesDropped issue( ERS_HERE, dropped );
+    issue.set_severity( (ers::severity)m_max_severity.exchange( ers::Debug, std::memory_order_relaxed ) );
+    chained().write( issue );
+}
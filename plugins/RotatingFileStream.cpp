@@ -0,0 +1,318 @@
+/*
+ *  RotatingFileStream.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <ers/SampleIssues.hpp>
+#include <ers/StreamFactory.hpp>
+#include <ers/internal/RotatingFileStream.hpp>
+#include <ers/internal/Util.hpp>
+
+ERS_REGISTER_OUTPUT_STREAM( ers::RotatingFileStream, "rfile", format )
+
+namespace
+{
+    const size_t DefaultMaxSize = 100 << 20;
+    const size_t DefaultKeep = 10;
+    const char * const CompressedSuffix = ".gz";
+    const char * const TemporarySuffix = ".tmp";
+
+    std::chrono::seconds parse_duration( const std::string & text )
+    {
+	char * end;
+	long value = ::strtol( text.c_str(), &end, 10 );
+	switch ( *end )
+	{
+	    case 'd': value *= 24; [[fallthrough]];
+	    case 'h': value *= 60; [[fallthrough]];
+	    case 'm': value *= 60; break;
+	    default: break;
+	}
+	return std::chrono::seconds( std::max( value, 0L ) );
+    }
+
+    void split( const std::string & file_name, std::string & directory, std::string & base_name )
+    {
+	std::string::size_type pos = file_name.rfind( '/' );
+	directory = pos == std::string::npos ? "." : file_name.substr( 0, pos + 1 );
+	base_name = pos == std::string::npos ? file_name : file_name.substr( pos + 1 );
+    }
+
+    // returns the names of the rotated files sorted from the oldest to the most recent one
+    std::vector<std::string> list_rotated( const std::string & file_name )
+    {
+	std::string directory, base_name;
+	split( file_name, directory, base_name );
+	base_name += '.';
+
+	std::vector<std::string> result;
+	DIR * dir = ::opendir( directory.c_str() );
+	if ( !dir )
+	    return result;
+
+	while ( struct dirent * e = ::readdir( dir ) )
+	{
+	    if (    !::strncmp( e->d_name, base_name.c_str(), base_name.size() )
+		 && ::isdigit( e->d_name[base_name.size()] )
+		 && !::strstr( e->d_name, TemporarySuffix ) )
+	    {
+		result.push_back( directory == "." ? e->d_name : directory + e->d_name );
+	    }
+	}
+	::closedir( dir );
+
+	std::sort( result.begin(), result.end() );
+	return result;
+    }
+
+    bool exists( const std::string & file_name )
+    {
+	struct stat st;
+	return !::stat( file_name.c_str(), &st );
+    }
+
+    bool ends_with( const std::string & s, const char * suffix )
+    {
+	size_t n = ::strlen( suffix );
+	return s.size() >= n && !s.compare( s.size() - n, n, suffix );
+    }
+}
+
+std::streamsize
+ers::RotatingFileStream::CountingBuffer::xsputn( const char * s, std::streamsize n )
+{
+    m_written += n;
+    return m_file.sputn( s, n );
+}
+
+ers::RotatingFileStream::CountingBuffer::int_type
+ers::RotatingFileStream::CountingBuffer::overflow( int_type c )
+{
+    if ( traits_type::eq_int_type( c, traits_type::eof() ) )
+	return traits_type::not_eof( c );
+    ++m_written;
+    return m_file.sputc( traits_type::to_char_type( c ) );
+}
+
+int
+ers::RotatingFileStream::CountingBuffer::sync()
+{
+    return m_file.pubsync();
+}
+
+ers::RotatingFileStream::RotatingFileStream( const std::string & format )
+  : m_max_size( DefaultMaxSize ),
+    m_max_age( 0 ),
+    m_keep( DefaultKeep ),
+    m_out( 0 ),
+    m_counter( 0 ),
+    m_terminated( false )
+{
+    std::vector<std::string> params;
+    ers::tokenize( format, ",", params );
+
+    m_file_name = params[0];
+    if ( params.size() > 1 )
+	m_max_size = ers::parse_size( params[1], DefaultMaxSize );
+    if ( params.size() > 2 )
+	m_max_age = parse_duration( params[2] );
+    if ( params.size() > 3 )
+	m_keep = ::strtoul( params[3].c_str(), 0, 10 );
+
+    open();
+
+    // compress the files which have been rotated but not compressed by a previous run
+    for ( const std::string & f : list_rotated( m_file_name ) )
+    {
+	if ( !ends_with( f, CompressedSuffix ) )
+	    m_to_compress.push_back( f );
+    }
+
+    m_compressor = std::thread( &ers::RotatingFileStream::compressor, this );
+}
+
+ers::RotatingFileStream::~RotatingFileStream()
+{
+    {
+	std::scoped_lock lock( m_compressor_mutex );
+	m_terminated = true;
+	m_compressor_condition.notify_one();
+    }
+    m_compressor.join();
+}
+
+void
+ers::RotatingFileStream::open()
+{
+    std::unique_ptr<CountingBuffer> buffer( new CountingBuffer );
+    if ( !buffer->m_file.open( m_file_name, std::ios::out | std::ios::app ) )
+    {
+	throw ers::CantOpenFile( ERS_HERE, m_file_name.c_str() );
+    }
+
+    struct stat st;
+    buffer->m_written = ::stat( m_file_name.c_str(), &st ) ? 0 : st.st_size;
+
+    m_out.rdbuf( buffer.get() );
+    m_buffer.swap( buffer );
+    m_opened = std::chrono::system_clock::now();
+}
+
+void
+ers::RotatingFileStream::rotate()
+{
+    char suffix[64];
+    std::time_t now = std::time( 0 );
+    std::tm tm;
+    size_t len = std::strftime( suffix, sizeof( suffix ), ".%Y%m%d-%H%M%S", ::localtime_r( &now, &tm ) );
+
+    // the counter starts from 0 in every process, so the name must not be used by a segment
+    // rotated by a previous run in the same second, which may have been already compressed
+    std::string rotated;
+    do {
+	::snprintf( suffix + len, sizeof( suffix ) - len, "-%04u", m_counter++ % 10000 );
+	rotated = m_file_name + suffix;
+    } while (	exists( rotated )
+	     || exists( rotated + CompressedSuffix )
+	     || exists( rotated + CompressedSuffix + TemporarySuffix ) );
+
+    // postpone the next attempt in case of failure
+    m_opened = std::chrono::system_clock::now();
+    m_buffer->m_written = 0;
+
+    if ( ::rename( m_file_name.c_str(), rotated.c_str() ) )
+    {
+	ERS_INTERNAL_ERROR( "Can not rename \"" << m_file_name << "\" to \"" << rotated << "\": " << ::strerror( errno ) )
+	return;
+    }
+
+    // the new file is opened before the old one is closed
+    std::unique_ptr<CountingBuffer> old( m_buffer.release() );
+    try
+    {
+	open();
+    }
+    catch ( ers::Issue & ex )
+    {
+	::rename( rotated.c_str(), m_file_name.c_str() );
+	m_buffer.swap( old );
+	ERS_INTERNAL_ERROR( ex )
+	return;
+    }
+    old->m_file.close();
+
+    std::scoped_lock lock( m_compressor_mutex );
+    m_to_compress.push_back( rotated );
+    m_compressor_condition.notify_one();
+}
+
+void
+ers::RotatingFileStream::write( const Issue & issue )
+{
+    {
+	std::scoped_lock lock( m_mutex );
+	if (    ( m_max_size && m_buffer->m_written >= m_max_size )
+	     || ( m_max_age.count() && issue.ptime() - m_opened >= m_max_age ) )
+	{
+	    rotate();
+	}
+	StandardStreamOutput::println( m_out, issue, Configuration::instance().verbosity_level() );
+    }
+    chained().write( issue );
+}
+
+void
+ers::RotatingFileStream::compressor()
+{
+    // compression must not compete with the application threads
+    pid_t tid = ::syscall( SYS_gettid );
+    ::setpriority( PRIO_PROCESS, tid, 19 );
+#ifdef SYS_ioprio_set
+    const int IOPRIO_WHO_PROCESS = 1, IOPRIO_CLASS_IDLE = 3, IOPRIO_CLASS_SHIFT = 13;
+    ::syscall( SYS_ioprio_set, IOPRIO_WHO_PROCESS, tid, IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT );
+#endif
+
+    std::unique_lock lock( m_compressor_mutex );
+    while ( true )
+    {
+	m_compressor_condition.wait( lock, [this](){ return !m_to_compress.empty() || m_terminated; } );
+	if ( m_to_compress.empty() )
+	    break;
+
+	std::string file_name = m_to_compress.front();
+	m_to_compress.pop_front();
+
+	lock.unlock();
+	// old files are removed first to avoid compressing the ones which are going to be deleted
+	remove_old_files();
+	compress( file_name );
+	lock.lock();
+    }
+}
+
+void
+ers::RotatingFileStream::compress( const std::string & file_name )
+{
+    FILE * in = ::fopen( file_name.c_str(), "rb" );
+    if ( !in )
+	return;
+
+    std::string temporary = file_name + CompressedSuffix + TemporarySuffix;
+    gzFile out = ::gzopen( temporary.c_str(), "wb6" );
+    if ( !out )
+    {
+	::fclose( in );
+	ERS_INTERNAL_ERROR( "Can not create \"" << temporary << "\" file" )
+	return;
+    }
+
+    bool ok = true;
+    char buffer[1 << 16];
+    size_t n;
+    while ( ok && ( n = ::fread( buffer, 1, sizeof( buffer ), in ) ) > 0 )
+    {
+	ok = ::gzwrite( out, buffer, n ) == (int)n;
+    }
+    ok = !::ferror( in ) && ::gzclose( out ) == Z_OK && ok;
+    ::fclose( in );
+
+    if ( ok && !::rename( temporary.c_str(), ( file_name + CompressedSuffix ).c_str() ) )
+    {
+	::unlink( file_name.c_str() );
+    }
+    else
+    {
+	::unlink( temporary.c_str() );
+	ERS_INTERNAL_ERROR( "Can not compress \"" << file_name << "\" file" )
+    }
+}
+
+void
+ers::RotatingFileStream::remove_old_files()
+{
+    if ( !m_keep )
+	return;
+
+    std::vector<std::string> files = list_rotated( m_file_name );
+    for ( size_t i = 0; i + m_keep < files.size(); ++i )
+    {
+	::unlink( files[i].c_str() );
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ *  SharedMemoryStream.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <stdlib.h>
+
+#include <vector>
+
+#include <ers/internal/SharedMemoryStream.hpp>
+#include <ers/internal/Util.hpp>
+#include <ers/internal/macro.hpp>
+#include <ers/StreamFactory.hpp>
+
+ERS_REGISTER_OUTPUT_STREAM( ers::SharedMemoryOutStream, "shm", format )
+
+ERS_REGISTER_INPUT_STREAM( ers::SharedMemoryInStream, "shm", params )
+
+namespace
+{
+    const std::chrono::milliseconds PollingTimeout( 100 );
+
+    ers::SharedMemoryQueue * create_queue( const std::vector<std::string> & params, bool consumer )
+    {
+	size_t size = params.size() > 1
+		? ers::parse_size( params[1], ers::SharedMemoryQueue::DefaultSize )
+		: ers::SharedMemoryQueue::DefaultSize;
+	size_t slot_size = params.size() > 2
+		? ers::parse_size( params[2], ers::SharedMemoryQueue::DefaultSlotSize )
+		: ers::SharedMemoryQueue::DefaultSlotSize;
+	mode_t mode = ers::SharedMemoryQueue::DefaultMode;
+	if ( params.size() > 3 )
+	{
+	    char * end;
+	    unsigned long m = ::strtoul( params[3].c_str(), &end, 8 );
+	    if ( end != params[3].c_str() && !*end && m <= 0777 )
+		mode = m;
+	    else
+		ERS_INTERNAL_WARNING( "Invalid access mode \"" << params[3] << "\" of the \"" << params[0]
+			<< "\" shared memory queue, 0" << std::oct << mode << " will be used" )
+	}
+	return new ers::SharedMemoryQueue( params.empty() ? "" : params[0], size, slot_size, consumer, mode );
+    }
+}
+
+ers::SharedMemoryOutStream::SharedMemoryOutStream( const std::string & format )
+{
+    std::vector<std::string> params;
+    ers::tokenize( format, ",", params );
+    m_queue.reset( create_queue( params, false ) );
+}
+
+void
+ers::SharedMemoryOutStream::write( const Issue & issue )
+{
+    m_queue->push( issue );
+    chained().write( issue );
+}
+
+ers::SharedMemoryInStream::SharedMemoryInStream( const std::initializer_list<std::string> & params )
+  : m_terminated( false )
+{
+    std::vector<std::string> p;
+    for ( const std::string & s : params )
+	ers::tokenize( s, ",", p );
+    m_queue.reset( create_queue( p, true ) );
+}
+
+ers::SharedMemoryInStream::~SharedMemoryInStream()
+{
+    m_terminated = true;
+    if ( m_thread.joinable() )
+	m_thread.join();
+}
+
+void
+ers::SharedMemoryInStream::start()
+{
+    if ( !m_thread.joinable() )
+	m_thread = std::thread( &ers::SharedMemoryInStream::run, this );
+}
+
+void
+ers::SharedMemoryInStream::run()
+{
+    while ( !m_terminated )
+    {
+	std::unique_ptr<Issue> issue = m_queue->pop( PollingTimeout );
+	if ( issue )
+	    receive( *issue );
+    }
+}
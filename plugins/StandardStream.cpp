@@ -7,14 +7,19 @@
  *
  */
 
+#include <condition_variable>
 #include <iostream>
 #include <fstream>
 #include <mutex>
+#include <thread>
 
 #include <ers/SampleIssues.hpp>
 
+#include <ers/internal/AsyncFileBuffer.hpp>
+#include <ers/internal/ExitHandlers.hpp>
 #include <ers/internal/StandardStream.hpp>
 #include <ers/internal/FormattedStandardStream.hpp>
+#include <ers/internal/Util.hpp>
 
 namespace
 {
@@ -137,6 +142,60 @@ namespace
       private:
       	std::ofstream out_;
     };
+
+    /** Writes to a file via io_uring. The device must be lockable, as a background thread
+      * has to submit the data which stay in the buffer longer than the flush interval.
+      */
+    template <class D>
+    struct AsyncFileDevice : public D
+    {
+	AsyncFileDevice( const std::string & file_name )
+          : D( out_ ),
+            buffer_( file_name,
+		     ers::parse_size( ers::read_from_environment( "DUNEDAQ_ERS_ASYNC_FILE_BUFFER_SIZE", "" ), 1 << 20 ),
+		     ers::read_from_environment( "DUNEDAQ_ERS_ASYNC_FILE_BUFFERS", 4 ),
+		     std::chrono::milliseconds(
+			ers::read_from_environment( "DUNEDAQ_ERS_ASYNC_FILE_FLUSH_INTERVAL", 100 ) ) ),
+            out_( &buffer_ ),
+            terminated_( false ),
+            flusher_( [this]() { flush(); } )
+	{
+	    ers::ExitHandlers::add( this, [this]() {
+		auto device = this->device();
+		buffer_.finish();
+	    } );
+	}
+
+	~AsyncFileDevice()
+	{
+	    ers::ExitHandlers::remove( this );
+	    {
+		std::scoped_lock lock( flusher_mutex_ );
+		terminated_ = true;
+	    }
+	    flusher_condition_.notify_one();
+	    flusher_.join();
+	}
+
+      private:
+	void flush()
+	{
+	    std::unique_lock lock( flusher_mutex_ );
+	    while ( !flusher_condition_.wait_for( lock, buffer_.flush_interval(), [this]() { return terminated_; } ) )
+	    {
+		auto device = this->device();
+		buffer_.flush();
+	    }
+	}
+
+      private:
+	ers::AsyncFileBuffer	buffer_;
+	std::ostream		out_;
+	std::mutex		flusher_mutex_;
+	std::condition_variable	flusher_condition_;
+	bool			terminated_;
+	std::thread		flusher_;
+    };
 }
 
 ERS_REGISTER_OUTPUT_STREAM( ers::StandardStream<FileDevice<OutDevice> >, "file", file_name )
@@ -144,6 +203,7 @@ ERS_REGISTER_OUTPUT_STREAM( ers::StandardStream<OutputDevice<OutDevice> >, "stdo
 ERS_REGISTER_OUTPUT_STREAM( ers::StandardStream<ErrorDevice<OutDevice> >, "stderr", ERS_EMPTY)
 
 ERS_REGISTER_OUTPUT_STREAM( ers::StandardStream<FileDevice<LockableDevice<> > >, "lfile", file_name )
+ERS_REGISTER_OUTPUT_STREAM( ers::StandardStream<AsyncFileDevice<LockableDevice<> > >, "afile", file_name )
 ERS_REGISTER_OUTPUT_STREAM( ers::StandardStream<OutputDevice<LockableDevice<ClassLock<1> > > >, "lstdout", ERS_EMPTY)
 ERS_REGISTER_OUTPUT_STREAM( ers::StandardStream<ErrorDevice<LockableDevice<ClassLock<2> > > >, "lstderr", ERS_EMPTY)
 
@@ -152,5 +212,6 @@ ERS_REGISTER_OUTPUT_STREAM( ers::FormattedStandardStream<OutputDevice<OutDevice>
 ERS_REGISTER_OUTPUT_STREAM( ers::FormattedStandardStream<ErrorDevice<OutDevice> >, "fstderr", format )
 
 ERS_REGISTER_OUTPUT_STREAM( ers::FormattedStandardStream<FileDevice<LockableDevice<> > >, "lffile", format )
+ERS_REGISTER_OUTPUT_STREAM( ers::FormattedStandardStream<AsyncFileDevice<LockableDevice<> > >, "affile", format )
 ERS_REGISTER_OUTPUT_STREAM( ers::FormattedStandardStream<OutputDevice<LockableDevice<ClassLock<1> > > >, "lfstdout", format )
 ERS_REGISTER_OUTPUT_STREAM( ers::FormattedStandardStream<ErrorDevice<LockableDevice<ClassLock<2> > > >, "lfstderr", format )
@@ -6,16 +6,39 @@
  *  Copyright 2004 CERN. All rights reserved.
  *
  */
-#include <boost/lexical_cast.hpp>
+#include <stdio.h>
+#include <time.h>
+
+#include <algorithm>
 
 #include <ers/internal/FilterStream.hpp>
+#include <ers/internal/Hash.hpp>
 #include <ers/internal/Util.hpp>
+#include <ers/internal/macro.hpp>
 #include <ers/StreamFactory.hpp>
 
 #include <ers/internal/ThrottleStream.hpp>
 
 ERS_REGISTER_OUTPUT_STREAM( ers::ThrottleStream, "throttle", format )
 
+namespace
+{
+    // the time of the last occurrence is formatted only when a suppression notice is sent
+    std::string
+    format_time( const system_clock::time_point & time )
+    {
+	std::time_t t = system_clock::to_time_t( time );
+	std::tm tm;
+	localtime_r( &t, &tm );
+
+	char buff[128];
+	size_t n = std::strftime( buff, sizeof( buff ), "%Y-%b-%d %H:%M:%S", &tm );
+	long us = std::chrono::duration_cast<std::chrono::microseconds>( time - system_clock::from_time_t( t ) ).count();
+	snprintf( buff + n, sizeof( buff ) - n, ",%06ld", us );
+	return buff;
+    }
+}
+
 ers::ThrottleStream::IssueRecord::IssueRecord()
 {
     reset();
@@ -24,40 +47,44 @@ ers::ThrottleStream::IssueRecord::IssueRecord()
 void 
 ers::ThrottleStream::IssueRecord::reset()
 {
-    m_lastOccurance=0;
+    m_lastOccurance=system_clock::time_point();
     m_lastReport=0;
     m_initialCounter=0;
     m_threshold=10;
     m_suppressedCounter=0;
+    m_suppressedIssue.reset();
 }
 
 void 
-ers::ThrottleStream::reportSuppression(IssueRecord& record, const ers::Issue& issue)
+ers::ThrottleStream::reportSuppression(int suppressed, const system_clock::time_point& lastOccurance, const ers::Issue& issue)
 {
     std::ostringstream msgStream;
-    msgStream << " -- " << record.m_suppressedCounter << " similar messages suppressed, last occurrence was at "
-		<< record.m_lastOccuranceFormatted;
+    msgStream << " -- " << suppressed << " similar messages suppressed, last occurrence was at "
+		<< format_time(lastOccurance);
     
-    ers::Issue* suppressedNotice = issue.clone();
+    std::unique_ptr<ers::Issue> suppressedNotice(issue.clone());
     suppressedNotice->wrap_message( "",  msgStream.str());
 
     suppressedNotice->set_severity(issue.severity());
     chained().write(*suppressedNotice);
-    delete suppressedNotice;
-
-    record.m_lastReport = issue.time_t();
-    record.m_suppressedCounter = 0;
 }
 
-void 
+ers::ThrottleStream::Decision
 ers::ThrottleStream::throttle(IssueRecord& rec, const ers::Issue& issue)
 {
+    Decision decision{ Decision::Suppress, 0, rec.m_lastOccurance };
+    auto notify = [&rec, &decision](std::time_t issueTime) {
+	decision.m_action = Decision::Notify;
+	decision.m_suppressed = rec.m_suppressedCounter;
+	rec.m_lastReport = issueTime;
+	rec.m_suppressedCounter = 0;
+	rec.m_suppressedIssue.reset();
+    };
+
     std::time_t issueTime=issue.time_t();
-    bool reported=false;
-    if (issueTime - rec.m_lastOccurance > m_timeLimit) {
+    if (issueTime - system_clock::to_time_t(rec.m_lastOccurance) > m_timeLimit) {
 	if (rec.m_suppressedCounter>0) {
-	   reportSuppression(rec, issue);
-	   reported=true;
+	   notify(issueTime);
 	}
 	rec.reset();
     }
@@ -65,32 +92,61 @@ ers::ThrottleStream::throttle(IssueRecord& rec, const ers::Issue& issue)
     if (rec.m_initialCounter<m_initialThreshold) {
 	rec.m_initialCounter++;
 	rec.m_lastReport=issueTime;
-	if (!reported) {
-	    chained().write(issue);
+	if (decision.m_action != Decision::Notify) {
+	    decision.m_action = Decision::Pass;
 	}
     }
     else if (rec.m_suppressedCounter>=rec.m_threshold) {
 	rec.m_threshold=rec.m_threshold*10;
-	reportSuppression(rec, issue);
+	notify(issueTime);
     }
     else if (issueTime - rec.m_lastReport > m_timeLimit) {
-	reportSuppression(rec, issue);
+	notify(issueTime);
     }
     else {
-	rec.m_suppressedCounter++;
+	if (!rec.m_suppressedCounter++) {
+	    rec.m_suppressedIssue.reset(issue.clone());
+	}
     }
 
-    rec.m_lastOccurance=issueTime;
-    rec.m_lastOccuranceFormatted=issue.time<std::chrono::microseconds>();
+    rec.m_lastOccurance=issue.ptime();
+    return decision;
+}
+
+void 
+ers::ThrottleStream::forget(Shard& shard, std::unordered_map<uint64_t, IssueRecord>::iterator it, std::vector<Notice>& notices)
+{
+    IssueRecord& rec = it->second;
+    if (rec.m_suppressedCounter > 0 && rec.m_suppressedIssue) {
+	notices.push_back(Notice{ rec.m_suppressedCounter, rec.m_lastOccurance, std::move(rec.m_suppressedIssue) });
+    }
+    shard.m_lru.erase(rec.m_lruPosition);
+    shard.m_records.erase(it);
+}
+
+void 
+ers::ThrottleStream::expire(Shard& shard, std::time_t now, std::vector<Notice>& notices)
+{
+    // the records are ordered by the time of the last occurrence, so the idle ones are at the end
+    while (!shard.m_lru.empty()) {
+	auto it = shard.m_records.find(shard.m_lru.back());
+	if (now - system_clock::to_time_t(it->second.m_lastOccurance) <= m_timeLimit) {
+	    break;
+	}
+	forget(shard, it, notices);
+    }
 }
 
 ers::ThrottleStream::ThrottleStream( const std::string & criteria )
 {
     m_initialThreshold = 30;
     m_timeLimit = 30;
+    size_t maxRecords = 10000;
+    m_keyType = Site;
+    m_nextSweep = 0;
     
     std::vector<std::string> params;
-    ers::tokenize( criteria, ",", params );
+    ers::tokenize_trimmed( criteria, ",", params );
     
     if ( params.size() > 0 )
     {
@@ -103,6 +159,62 @@ ers::ThrottleStream::ThrottleStream( const std::string & criteria )
 	std::istringstream in( params[1] );
         in >> m_timeLimit;
     }
+
+    if ( params.size() > 2 )
+    {
+	std::istringstream in( params[2] );
+        in >> maxRecords;
+    }
+    m_maxRecords = std::max<size_t>( maxRecords / ShardsNumber, 1 );
+
+    if ( params.size() > 3 )
+    {
+	std::vector<std::string> key;
+	ers::tokenize_trimmed( params[3], ":", key );
+	if ( key.size() == 1 && key[0] == "site" )
+	    m_keyType = Site;
+	else if ( key.size() == 1 && key[0] == "class" )
+	    m_keyType = SiteClass;
+	else if ( key.size() == 1 && key[0] == "fingerprint" )
+	    m_keyType = Fingerprint;
+	else if ( key.size() > 1 && key[0] == "params" )
+	{
+	    m_keyType = SiteParameters;
+	    m_keyParameters.assign( key.begin() + 1, key.end() );
+	}
+	else
+	    ERS_INTERNAL_WARNING( "Unknown throttle key \"" << params[3]
+		<< "\", issues will be identified by their file name and line number" )
+    }
+}
+
+uint64_t
+ers::ThrottleStream::issueKey( const ers::Issue & issue ) const
+{
+    const ers::Context& context = issue.context();
+    uint64_t key = ers::hash_combine( ers::hash( context.file_name() ), context.line_number() );
+
+    switch ( m_keyType )
+    {
+	case Site:
+	    break;
+	case SiteClass:
+	    key = ers::hash( issue.get_class_name(), key );
+	    break;
+	case SiteParameters:
+	    for ( const std::string & name : m_keyParameters )
+	    {
+		auto it = issue.parameters().find( name );
+		key = it == issue.parameters().end() ? ers::hash_combine( key, 0 ) : ers::hash( it->second, key );
+	    }
+	    break;
+	case Fingerprint:
+	    key = ers::hash( issue.get_class_name(), key );
+	    for ( const auto & p : issue.parameters() )
+		key = ers::hash( p.second, ers::hash( p.first, key ) );
+	    break;
+    }
+    return key;
 }
 
 /** Write method 
@@ -114,9 +226,48 @@ ers::ThrottleStream::ThrottleStream( const std::string & criteria )
 void 
 ers::ThrottleStream::write( const ers::Issue & issue )
 {
-    const ers::Context& context = issue.context();
-    std::string issueId = context.file_name() + boost::lexical_cast<std::string>(context.line_number());
+    uint64_t issueId = issueKey( issue );
+
+    Shard & shard = m_shards[issueId % ShardsNumber];
+    Decision decision;
+    std::vector<Notice> notices;
+    {
+	// the idle records are removed from all shards by the thread which first finds that the time has come
+	std::time_t issueTime = issue.time_t();
+	std::time_t nextSweep = m_nextSweep.load( std::memory_order_relaxed );
+	if ( issueTime >= nextSweep && m_nextSweep.compare_exchange_strong( nextSweep, issueTime + m_timeLimit ) )
+	{
+	    for ( Shard & s : m_shards )
+	    {
+		std::scoped_lock ml(s.m_mutex);
+		expire( s, issueTime, notices );
+	    }
+	}
+
+	std::scoped_lock ml(shard.m_mutex);
+	auto it = shard.m_records.find( issueId );
+	if ( it == shard.m_records.end() )
+	{
+	    if ( shard.m_records.size() >= m_maxRecords )
+		forget( shard, shard.m_records.find( shard.m_lru.back() ), notices );
+	    shard.m_lru.push_front( issueId );
+	    it = shard.m_records.emplace( issueId, IssueRecord() ).first;
+	    it->second.m_lruPosition = shard.m_lru.begin();
+	}
+	else if ( it->second.m_lruPosition != shard.m_lru.begin() )
+	{
+	    shard.m_lru.splice( shard.m_lru.begin(), shard.m_lru, it->second.m_lruPosition );
+	}
+
+	decision = throttle( it->second, issue );
+    }
+
+    // the chained streams are called without holding the lock
+    for ( Notice & n : notices )
+	reportSuppression( n.m_suppressed, n.m_lastOccurance, *n.m_issue );
 
-    std::scoped_lock ml(m_mutex);
-    throttle( m_issueMap[issueId], issue );
+    if ( decision.m_action == Decision::Pass )
+	chained().write( issue );
+    else if ( decision.m_action == Decision::Notify )
+	reportSuppression( decision.m_suppressed, decision.m_lastOccurance, issue );
 }
@@ -0,0 +1,437 @@
+/*
+ *  WhereStream.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include <ers/ers.hpp>
+#include <ers/internal/Hash.hpp>
+#include <ers/internal/WhereStream.hpp>
+
+ERS_DECLARE_ISSUE( ers,
+		   BadExpression,
+		   "Expression \"" << expression << "\" is invalid: " << reason,
+		   ((std::string)expression )
+		   ((std::string)reason ) )
+
+ERS_REGISTER_OUTPUT_STREAM( ers::WhereStream, "where", expression )
+
+namespace
+{
+    const size_t MaxInheritanceResults = 4096;
+
+    const char * const Delimiters = "&|()";
+
+    bool
+    to_number( const std::string & s, double & value )
+    {
+	if ( s.empty() )
+	    return false;
+
+	char * end;
+	value = ::strtod( s.c_str(), &end );
+	return *end == 0;
+    }
+}
+
+/** Recursive descent parser, which translates the expression into a sequence of instructions.
+  * The && and || operators are compiled into conditional jumps, so the evaluation is short-circuited
+  * and needs a single boolean register.
+  */
+struct ers::WhereStream::Parser
+{
+    Parser( const std::string & expression, WhereStream & stream )
+      : m_expression( expression ),
+	m_position( 0 ),
+	m_stream( stream )
+    { ; }
+
+    void parse()
+    {
+	skip();
+	if ( m_position < m_expression.size() )
+	    parse_or();
+
+	skip();
+	if ( m_position < m_expression.size() )
+	    error( "unexpected character" );
+    }
+
+  private:
+    [[noreturn]] void error( const std::string & reason )
+    {
+	throw ers::BadExpression( ERS_HERE, m_expression, reason + " at position " + std::to_string( m_position ) );
+    }
+
+    void skip()
+    {
+	while ( m_position < m_expression.size() && ::isspace( m_expression[m_position] ) )
+	    ++m_position;
+    }
+
+    bool accept( const char * token )
+    {
+	skip();
+	size_t length = ::strlen( token );
+	if ( m_expression.compare( m_position, length, token ) )
+	    return false;
+
+	m_position += length;
+	return true;
+    }
+
+    size_t emit( OpCode code, uint32_t argument = 0 )
+    {
+	m_stream.m_code.push_back( { code, argument } );
+	return m_stream.m_code.size() - 1;
+    }
+
+    void patch( const std::vector<size_t> & jumps )
+    {
+	for ( size_t j : jumps )
+	    m_stream.m_code[j].m_argument = m_stream.m_code.size();
+    }
+
+    void parse_or()
+    {
+	std::vector<size_t> jumps;
+	parse_and();
+	while ( accept( "||" ) )
+	{
+	    jumps.push_back( emit( JumpIfTrue ) );
+	    parse_and();
+	}
+	patch( jumps );
+    }
+
+    void parse_and()
+    {
+	std::vector<size_t> jumps;
+	parse_unary();
+	while ( accept( "&&" ) )
+	{
+	    jumps.push_back( emit( JumpIfFalse ) );
+	    parse_unary();
+	}
+	patch( jumps );
+    }
+
+    void parse_unary()
+    {
+	if ( accept( "!" ) )
+	{
+	    parse_unary();
+	    emit( Not );
+	}
+	else if ( accept( "(" ) )
+	{
+	    parse_or();
+	    if ( !accept( ")" ) )
+		error( "')' is expected" );
+	}
+	else
+	{
+	    parse_predicate();
+	}
+    }
+
+    Field parse_field( std::string & parameter )
+    {
+	static const std::pair<const char *, Field> fields[] = {
+	    { "severity", Severity }, { "class", Class }, { "package", Package }, { "function", Function },
+	    { "file", File }, { "line", Line }, { "host", Host }, { "app", Application },
+	    { "message", Message }, { "qualifier", Qualifier } };
+
+	skip();
+	size_t start = m_position;
+	while ( m_position < m_expression.size()
+		&& ( ::isalnum( m_expression[m_position] ) || ::strchr( "_.", m_expression[m_position] ) ) )
+	    ++m_position;
+
+	std::string name = m_expression.substr( start, m_position - start );
+	if ( name.empty() )
+	    error( "field name is expected" );
+
+	for ( const auto & f : fields )
+	{
+	    if ( name == f.first )
+		return f.second;
+	}
+
+	if ( name.compare( 0, 6, "param." ) == 0 && name.size() > 6 )
+	{
+	    parameter = name.substr( 6 );
+	    return Parameter;
+	}
+
+	m_position = start;
+	error( "unknown field \"" + name + "\"" );
+    }
+
+    Comparison parse_comparison()
+    {
+	static const std::pair<const char *, Comparison> comparisons[] = {
+	    { "==", Equal }, { "!=", NotEqual }, { "<=", LessEqual }, { ">=", GreaterEqual },
+	    { "<", Less }, { ">", Greater }, { "~", Match }, { "=", Equal } };
+
+	for ( const auto & c : comparisons )
+	{
+	    if ( accept( c.first ) )
+		return c.second;
+	}
+	error( "comparison operator is expected" );
+    }
+
+    std::string parse_value()
+    {
+	skip();
+	size_t start = m_position;
+	if ( m_position < m_expression.size() && ::strchr( "'\"", m_expression[m_position] ) )
+	{
+	    size_t end = m_expression.find( m_expression[m_position], m_position + 1 );
+	    if ( end == std::string::npos )
+		error( "unterminated string" );
+	    m_position = end + 1;
+	    return m_expression.substr( start + 1, end - start - 1 );
+	}
+
+	while ( m_position < m_expression.size()
+		&& !::isspace( m_expression[m_position] ) && !::strchr( Delimiters, m_expression[m_position] ) )
+	    ++m_position;
+
+	if ( m_position == start )
+	    error( "value is expected" );
+	return m_expression.substr( start, m_position - start );
+    }
+
+    void parse_predicate()
+    {
+	Predicate p;
+	p.m_field = parse_field( p.m_name );
+	p.m_comparison = parse_comparison();
+	size_t position = m_position;
+	p.m_text = parse_value();
+	p.m_numeric = to_number( p.m_text, p.m_number );
+
+	// errors in the value are reported at its start
+	auto fail = [this, position]( const std::string & reason )
+	{
+	    m_position = position;
+	    error( reason );
+	};
+
+	switch ( p.m_field )
+	{
+	    case Severity:
+	    {
+		std::string name( p.m_text );
+		std::transform( name.begin(), name.end(), name.begin(), ::toupper );
+		if ( name == "INFORMATION" )
+		    name = "INFO";
+
+		int s = ers::Debug;
+		while ( s <= ers::Fatal && name != ers::to_string( (ers::severity)s ) )
+		    ++s;
+
+		if ( s > ers::Fatal )
+		    fail( "unknown severity \"" + p.m_text + "\"" );
+		if ( p.m_comparison == Match )
+		    fail( "severity can not be matched" );
+		p.m_number = s;
+		break;
+	    }
+	    case Line:
+		if ( !p.m_numeric )
+		    fail( "line number is expected" );
+		if ( p.m_comparison == Match )
+		    fail( "line number can not be matched" );
+		break;
+	    case Class:
+		if ( p.m_comparison != Equal && p.m_comparison != NotEqual && p.m_comparison != Match )
+		    fail( "class names can not be ordered" );
+		break;
+	    default:
+		if ( p.m_comparison == Match )
+		{
+		    try
+		    {
+			p.m_regex.assign( p.m_text );
+		    }
+		    catch ( boost::regex_error & ex )
+		    {
+			fail( std::string( "bad regular expression: " ) + ex.what() );
+		    }
+		}
+		break;
+	}
+
+	m_stream.m_predicates.push_back( std::move( p ) );
+	emit( Test, m_stream.m_predicates.size() - 1 );
+    }
+
+    const std::string &	m_expression;
+    size_t		m_position;
+    WhereStream &	m_stream;
+};
+
+ers::WhereStream::WhereStream( const std::string & expression )
+{
+    Parser( expression, *this ).parse();
+}
+
+void
+ers::WhereStream::write( const Issue & issue )
+{
+    if ( evaluate( issue ) )
+    {
+	chained().write( issue );
+    }
+}
+
+bool
+ers::WhereStream::evaluate( const Issue & issue )
+{
+    bool result = true;
+    size_t pc = 0;
+    while ( pc < m_code.size() )
+    {
+	const Instruction & i = m_code[pc++];
+	switch ( i.m_code )
+	{
+	    case Test:
+		result = test( m_predicates[i.m_argument], issue );
+		break;
+	    case Not:
+		result = !result;
+		break;
+	    case JumpIfFalse:
+		if ( !result )
+		    pc = i.m_argument;
+		break;
+	    case JumpIfTrue:
+		if ( result )
+		    pc = i.m_argument;
+		break;
+	}
+    }
+    return result;
+}
+
+bool
+ers::WhereStream::compare( int order, Comparison comparison )
+{
+    switch ( comparison )
+    {
+	case Equal:		return order == 0;
+	case NotEqual:		return order != 0;
+	case Less:		return order < 0;
+	case LessEqual:		return order <= 0;
+	case Greater:		return order > 0;
+	case GreaterEqual:	return order >= 0;
+	default:		return false;
+    }
+}
+
+bool
+ers::WhereStream::test( const Predicate & p, const char * text, size_t length )
+{
+    if ( p.m_comparison == Match )
+    {
+	return boost::regex_search( text, text + length, p.m_regex );
+    }
+
+    int order = ::strncmp( text, p.m_text.c_str(), length );
+    if ( !order && length < p.m_text.size() )
+	order = -1;
+    return compare( order, p.m_comparison );
+}
+
+bool
+ers::WhereStream::test( const Predicate & p, const Issue & issue )
+{
+    const Context & context = issue.context();
+    switch ( p.m_field )
+    {
+	case Severity:
+	    return compare( issue.severity().type - (int)p.m_number, p.m_comparison );
+	case Line:
+	    return compare( ( context.line_number() > p.m_number ) - ( context.line_number() < p.m_number ), p.m_comparison );
+	case Class:
+	    if ( p.m_comparison == Match )
+		return inherits( p, issue );
+	    return compare( ::strcmp( issue.get_class_name(), p.m_text.c_str() ), p.m_comparison );
+	case Package:
+	    return test( p, context.package_name(), ::strlen( context.package_name() ) );
+	case Function:
+	    // Remove the function arguments, which could lead to fake matches
+	    return test( p, context.function_name(), ::strcspn( context.function_name(), "(" ) );
+	case File:
+	    return test( p, context.file_name(), ::strlen( context.file_name() ) );
+	case Host:
+	    return test( p, context.host_name(), ::strlen( context.host_name() ) );
+	case Application:
+	    return test( p, context.application_name(), ::strlen( context.application_name() ) );
+	case Message:
+	    return test( p, issue.message().c_str(), issue.message().size() );
+	case Qualifier:
+	{
+	    // "qualifier!=X" is true if none of the qualifiers is equal to X
+	    bool negate = p.m_comparison == NotEqual;
+	    for ( const std::string & q : issue.qualifiers() )
+	    {
+		if ( test( p, q.c_str(), q.size() ) != negate )
+		    return !negate;
+	    }
+	    return negate;
+	}
+	case Parameter:
+	{
+	    auto it = issue.parameters().find( p.m_name );
+	    if ( it == issue.parameters().end() )
+		return false;
+
+	    if ( p.m_numeric && p.m_comparison != Match )
+	    {
+		double value;
+		if ( !to_number( it->second, value ) )
+		    return false;
+		return compare( ( value > p.m_number ) - ( value < p.m_number ), p.m_comparison );
+	    }
+	    return test( p, it->second.c_str(), it->second.size() );
+	}
+    }
+    return false;
+}
+
+bool
+ers::WhereStream::inherits( const Predicate & p, const Issue & issue )
+{
+    const char * name = issue.get_class_name();
+    if ( p.m_text == name )
+	return true;
+
+    uint64_t key = ers::hash( name, &p - m_predicates.data() );
+    {
+	std::shared_lock lock( m_mutex );
+	auto it = m_inheritance.find( key );
+	if ( it != m_inheritance.end() )
+	    return it->second;
+    }
+
+    ers::inheritance_type chain = issue.get_class_inheritance();
+    bool result = std::find( chain.begin(), chain.end(), p.m_text ) != chain.end();
+
+    std::unique_lock lock( m_mutex );
+    if ( m_inheritance.size() >= MaxInheritanceResults )
+	m_inheritance.clear();
+    m_inheritance.emplace( key, result );
+    return result;
+}
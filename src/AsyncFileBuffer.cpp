@@ -0,0 +1,362 @@
+/*
+ *  AsyncFileBuffer.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/falloc.h>
+#include <linux/io_uring.h>
+
+#include <algorithm>
+#include <new>
+
+#include <ers/SampleIssues.hpp>
+#include <ers/internal/AsyncFileBuffer.hpp>
+#include <ers/internal/macro.hpp>
+
+namespace
+{
+    const off_t PreallocationChunk = 64 << 20;
+
+    int io_uring_setup( unsigned int entries, struct io_uring_params * p )
+    {
+	return ::syscall( __NR_io_uring_setup, entries, p );
+    }
+
+    int io_uring_enter( int fd, unsigned int to_submit, unsigned int min_complete, unsigned int flags )
+    {
+	int r;
+	while ( ( r = ::syscall( __NR_io_uring_enter, fd, to_submit, min_complete, flags, 0, 0 ) ) < 0
+		&& errno == EINTR )
+	    ;
+	return r;
+    }
+
+    int io_uring_register( int fd, unsigned int opcode, const void * arg, unsigned int args_number )
+    {
+	return ::syscall( __NR_io_uring_register, fd, opcode, arg, args_number );
+    }
+}
+
+struct ers::AsyncFileBuffer::Ring
+{
+    void *		m_sq_ptr = MAP_FAILED;
+    size_t		m_sq_size = 0;
+    void *		m_cq_ptr = MAP_FAILED;
+    size_t		m_cq_size = 0;
+    io_uring_sqe *	m_sqes = (io_uring_sqe *)MAP_FAILED;
+    size_t		m_sqes_size = 0;
+
+    unsigned int *	m_sq_tail;
+    unsigned int *	m_sq_mask;
+    unsigned int *	m_sq_array;
+    unsigned int *	m_cq_head;
+    unsigned int *	m_cq_tail;
+    unsigned int *	m_cq_mask;
+    io_uring_cqe *	m_cqes;
+
+    ~Ring()
+    {
+	if ( m_sqes != MAP_FAILED )
+	    ::munmap( m_sqes, m_sqes_size );
+	if ( m_cq_ptr != MAP_FAILED && m_cq_ptr != m_sq_ptr )
+	    ::munmap( m_cq_ptr, m_cq_size );
+	if ( m_sq_ptr != MAP_FAILED )
+	    ::munmap( m_sq_ptr, m_sq_size );
+    }
+};
+
+ers::AsyncFileBuffer::AsyncFileBuffer( const std::string & file_name,
+				       size_t buffer_size,
+				       size_t buffers_number,
+				       std::chrono::milliseconds flush_interval )
+  : m_file_name( file_name ),
+    m_buffer_size( std::max( buffer_size, (size_t)::getpagesize() ) ),
+    m_flush_interval( flush_interval ),
+    m_fd( -1 ),
+    m_ring_fd( -1 ),
+    m_ring( 0 ),
+    m_fixed( false ),
+    m_synchronous( true ),
+    m_memory( MAP_FAILED ),
+    m_buffers( std::max( buffers_number, (size_t)2 ) ),
+    m_current( 0 ),
+    m_in_flight( 0 ),
+    m_offset( 0 ),
+    m_allocated( 0 ),
+    m_submitted( std::chrono::steady_clock::now() )
+{
+    m_fd = ::open( file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666 );
+    if ( m_fd < 0 )
+    {
+	throw ers::CantOpenFile( ERS_HERE, file_name.c_str() );
+    }
+
+    m_memory = ::mmap( 0, m_buffer_size * m_buffers.size(), PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0 );
+    if ( m_memory == MAP_FAILED )
+    {
+	::close( m_fd );
+	throw std::bad_alloc();
+    }
+
+    for ( size_t i = 0; i < m_buffers.size(); ++i )
+    {
+	m_buffers[i] = Buffer{ (char *)m_memory + i * m_buffer_size, 0, 0, false };
+    }
+
+    m_synchronous = !setup_ring();
+
+    setp( m_buffers[0].m_data, m_buffers[0].m_data + m_buffer_size );
+}
+
+ers::AsyncFileBuffer::~AsyncFileBuffer()
+{
+    finish();
+    close_ring();
+    ::munmap( m_memory, m_buffer_size * m_buffers.size() );
+    ::close( m_fd );
+}
+
+bool
+ers::AsyncFileBuffer::setup_ring()
+{
+    struct io_uring_params p;
+    ::memset( &p, 0, sizeof( p ) );
+
+    m_ring_fd = io_uring_setup( m_buffers.size(), &p );
+    if ( m_ring_fd < 0 )
+	return false;
+
+    m_ring = new Ring;
+    m_ring->m_sq_size = p.sq_off.array + p.sq_entries * sizeof( unsigned int );
+    m_ring->m_cq_size = p.cq_off.cqes + p.cq_entries * sizeof( io_uring_cqe );
+    bool single_mmap = p.features & IORING_FEAT_SINGLE_MMAP;
+    if ( single_mmap )
+	m_ring->m_sq_size = m_ring->m_cq_size = std::max( m_ring->m_sq_size, m_ring->m_cq_size );
+
+    m_ring->m_sq_ptr = ::mmap( 0, m_ring->m_sq_size, PROT_READ | PROT_WRITE,
+				MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_SQ_RING );
+    m_ring->m_cq_ptr = single_mmap ? m_ring->m_sq_ptr
+				   : ::mmap( 0, m_ring->m_cq_size, PROT_READ | PROT_WRITE,
+					     MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_CQ_RING );
+    m_ring->m_sqes_size = p.sq_entries * sizeof( io_uring_sqe );
+    m_ring->m_sqes = (io_uring_sqe *)::mmap( 0, m_ring->m_sqes_size, PROT_READ | PROT_WRITE,
+					      MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_SQES );
+
+    if (    m_ring->m_sq_ptr == MAP_FAILED
+	 || m_ring->m_cq_ptr == MAP_FAILED
+	 || m_ring->m_sqes == MAP_FAILED )
+    {
+	close_ring();
+	return false;
+    }
+
+    char * sq = (char *)m_ring->m_sq_ptr;
+    char * cq = (char *)m_ring->m_cq_ptr;
+    m_ring->m_sq_tail = (unsigned int *)( sq + p.sq_off.tail );
+    m_ring->m_sq_mask = (unsigned int *)( sq + p.sq_off.ring_mask );
+    m_ring->m_sq_array = (unsigned int *)( sq + p.sq_off.array );
+    m_ring->m_cq_head = (unsigned int *)( cq + p.cq_off.head );
+    m_ring->m_cq_tail = (unsigned int *)( cq + p.cq_off.tail );
+    m_ring->m_cq_mask = (unsigned int *)( cq + p.cq_off.ring_mask );
+    m_ring->m_cqes = (io_uring_cqe *)( cq + p.cq_off.cqes );
+
+    // registration may fail because of the locked memory limit, in which case
+    // the buffers are passed to the kernel with every request
+    std::vector<struct iovec> iov( m_buffers.size() );
+    for ( size_t i = 0; i < m_buffers.size(); ++i )
+    {
+	iov[i].iov_base = m_buffers[i].m_data;
+	iov[i].iov_len = m_buffer_size;
+    }
+    m_fixed = !io_uring_register( m_ring_fd, IORING_REGISTER_BUFFERS, iov.data(), iov.size() );
+
+    return true;
+}
+
+void
+ers::AsyncFileBuffer::close_ring()
+{
+    delete m_ring;
+    m_ring = 0;
+    if ( m_ring_fd >= 0 )
+	::close( m_ring_fd );
+    m_ring_fd = -1;
+    m_synchronous = true;
+}
+
+bool
+ers::AsyncFileBuffer::submit()
+{
+    Buffer & b = m_buffers[m_current];
+    b.m_size = pptr() - pbase();
+    if ( !b.m_size )
+	return false;
+
+    b.m_offset = m_offset;
+    m_offset += b.m_size;
+    m_submitted = std::chrono::steady_clock::now();
+    preallocate( m_offset );
+
+    if ( m_synchronous )
+    {
+	write_sync( b, 0 );
+	return true;
+    }
+
+    unsigned int tail = *m_ring->m_sq_tail;
+    unsigned int index = tail & *m_ring->m_sq_mask;
+    io_uring_sqe & sqe = m_ring->m_sqes[index];
+    ::memset( &sqe, 0, sizeof( sqe ) );
+    sqe.opcode = m_fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+    sqe.fd = m_fd;
+    sqe.addr = (uint64_t)b.m_data;
+    sqe.len = b.m_size;
+    sqe.off = b.m_offset;
+    sqe.buf_index = m_current;
+    sqe.user_data = m_current;
+    m_ring->m_sq_array[index] = index;
+    __atomic_store_n( m_ring->m_sq_tail, tail + 1, __ATOMIC_RELEASE );
+
+    if ( io_uring_enter( m_ring_fd, 1, 0, 0 ) != 1 )
+    {
+	// the request has not been consumed by the kernel, so it can be withdrawn
+	__atomic_store_n( m_ring->m_sq_tail, tail, __ATOMIC_RELEASE );
+	write_sync( b, 0 );
+	m_synchronous = true;
+	return true;
+    }
+
+    b.m_busy = true;
+    ++m_in_flight;
+    return true;
+}
+
+void
+ers::AsyncFileBuffer::write_sync( Buffer & b, size_t done )
+{
+    while ( done < b.m_size )
+    {
+	ssize_t r = ::pwrite( m_fd, b.m_data + done, b.m_size - done, b.m_offset + done );
+	if ( r < 0 && errno == EINTR )
+	    continue;
+	if ( r <= 0 )
+	{
+	    ERS_INTERNAL_ERROR( "Can not write to the \"" << m_file_name << "\" file: " << ::strerror( errno ) )
+	    break;
+	}
+	done += r;
+    }
+}
+
+void
+ers::AsyncFileBuffer::reap( unsigned int wait_for )
+{
+    if ( !m_in_flight )
+	return;
+
+    if ( wait_for )
+	io_uring_enter( m_ring_fd, 0, wait_for, IORING_ENTER_GETEVENTS );
+
+    unsigned int head = *m_ring->m_cq_head;
+    unsigned int tail = __atomic_load_n( m_ring->m_cq_tail, __ATOMIC_ACQUIRE );
+    for ( ; head != tail; ++head )
+    {
+	const io_uring_cqe & cqe = m_ring->m_cqes[head & *m_ring->m_cq_mask];
+	Buffer & b = m_buffers[cqe.user_data];
+	if ( cqe.res < 0 )
+	{
+	    // the kernel does not support the requested operation
+	    if ( cqe.res == -EINVAL || cqe.res == -EOPNOTSUPP )
+		m_synchronous = true;
+	    write_sync( b, 0 );
+	}
+	else if ( (size_t)cqe.res < b.m_size )
+	{
+	    write_sync( b, cqe.res );
+	}
+	b.m_busy = false;
+	--m_in_flight;
+    }
+    __atomic_store_n( m_ring->m_cq_head, head, __ATOMIC_RELEASE );
+}
+
+void
+ers::AsyncFileBuffer::next_buffer()
+{
+    m_current = ( m_current + 1 ) % m_buffers.size();
+    while ( m_buffers[m_current].m_busy )
+	reap( 1 );
+
+    setp( m_buffers[m_current].m_data, m_buffers[m_current].m_data + m_buffer_size );
+}
+
+void
+ers::AsyncFileBuffer::preallocate( off_t end )
+{
+    if ( m_allocated < 0 || end <= m_allocated )
+	return;
+
+    off_t chunk = std::max( PreallocationChunk, (off_t)( 16 * m_buffer_size ) );
+    off_t size = ( end + chunk - 1 ) / chunk * chunk;
+    if ( ::fallocate( m_fd, FALLOC_FL_KEEP_SIZE, m_allocated, size - m_allocated ) )
+	m_allocated = -1;	// the file system does not support preallocation
+    else
+	m_allocated = size;
+}
+
+void
+ers::AsyncFileBuffer::flush()
+{
+    if ( m_ring )
+	reap( 0 );
+    if ( submit() )
+	next_buffer();
+}
+
+void
+ers::AsyncFileBuffer::finish()
+{
+    flush();
+    while ( m_in_flight )
+	reap( 1 );
+
+    // truncating to the current size releases the space preallocated beyond the end of the file
+    if ( m_allocated > m_offset )
+    {
+	if ( !::ftruncate( m_fd, m_offset ) )
+	    m_allocated = m_offset;
+    }
+}
+
+ers::AsyncFileBuffer::int_type
+ers::AsyncFileBuffer::overflow( int_type c )
+{
+    flush();
+    if ( !traits_type::eq_int_type( c, traits_type::eof() ) )
+    {
+	*pptr() = traits_type::to_char_type( c );
+	pbump( 1 );
+    }
+    return traits_type::not_eof( c );
+}
+
+int
+ers::AsyncFileBuffer::sync()
+{
+    if ( m_ring )
+	reap( 0 );
+    if ( std::chrono::steady_clock::now() - m_submitted >= m_flush_interval )
+	flush();
+    return 0;
+}
@@ -0,0 +1,219 @@
+/*
+ *  BinaryRecord.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include <ers/Issue.hpp>
+#include <ers/IssueFactory.hpp>
+#include <ers/RemoteContext.hpp>
+#include <ers/internal/BinaryRecord.hpp>
+
+namespace
+{
+    struct Header
+    {
+	int64_t		time;
+	int32_t		rank;
+	int32_t		pid;
+	int32_t		tid;
+	int32_t		uid;
+	int32_t		line;
+	uint16_t	version;
+	uint16_t	severity;
+	uint16_t	lengths[ers::BinaryRecord::FieldsNumber];
+    };
+
+    struct Writer
+    {
+	Writer( char * buffer, size_t size )
+	  : m_ptr( buffer ),
+	    m_end( buffer + size )
+	{ ; }
+
+	size_t available() const
+	{ return m_end - m_ptr; }
+
+	size_t put( const char * data, size_t length )
+	{
+	    length = std::min( length, available() );
+	    ::memcpy( m_ptr, data, length );
+	    m_ptr += length;
+	    return length;
+	}
+
+	bool put_item( const std::string & item )
+	{
+	    uint16_t length = std::min<size_t>( item.size(), UINT16_MAX );
+	    if ( available() < sizeof( length ) + length )
+		return false;
+	    put( (const char *)&length, sizeof( length ) );
+	    put( item.data(), length );
+	    return true;
+	}
+
+	char * m_ptr;
+	char * m_end;
+    };
+
+    const char * read_item( const char * ptr, const char * end, std::string_view & item )
+    {
+	uint16_t length;
+	if ( end - ptr < (ptrdiff_t)sizeof( length ) )
+	    return 0;
+	::memcpy( &length, ptr, sizeof( length ) );
+	ptr += sizeof( length );
+	if ( end - ptr < length )
+	    return 0;
+	item = std::string_view( ptr, length );
+	return ptr + length;
+    }
+}
+
+size_t
+ers::BinaryRecord::encode( const Issue & issue, char * buffer, size_t size )
+{
+    if ( size < sizeof( Header ) )
+	return 0;
+
+    const Context & c = issue.context();
+    Header h;
+    h.time = std::chrono::duration_cast<std::chrono::nanoseconds>( issue.ptime().time_since_epoch() ).count();
+    h.rank = issue.severity().rank;
+    h.pid = c.process_id();
+    h.tid = c.thread_id();
+    h.uid = c.user_id();
+    h.line = c.line_number();
+    h.version = Version;
+    h.severity = issue.severity().type;
+
+    Writer out( buffer + sizeof( Header ), size - sizeof( Header ) );
+
+    const char * strings[] = {
+	issue.get_class_name(), c.package_name(), c.file_name(), c.host_name(), c.application_name() };
+    for ( size_t i = 0; i < sizeof( strings ) / sizeof( strings[0] ); ++i )
+    {
+	h.lengths[i] = out.put( strings[i], std::min<size_t>( ::strlen( strings[i] ), UINT16_MAX ) );
+    }
+    h.lengths[Message] = out.put( issue.message().data(), std::min<size_t>( issue.message().size(), UINT16_MAX ) );
+    h.lengths[Function] = out.put( c.function_name(), std::min<size_t>( ::strlen( c.function_name() ), UINT16_MAX ) );
+
+    char * start = out.m_ptr;
+    for ( const std::string & q : issue.qualifiers() )
+    {
+	if ( !out.put_item( q ) )
+	    break;
+    }
+    h.lengths[Qualifiers] = out.m_ptr - start;
+
+    start = out.m_ptr;
+    for ( const auto & p : issue.parameters() )
+    {
+	char * item = out.m_ptr;
+	if ( !out.put_item( p.first ) || !out.put_item( p.second ) )
+	{
+	    out.m_ptr = item;
+	    break;
+	}
+    }
+    h.lengths[Parameters] = out.m_ptr - start;
+
+    ::memcpy( buffer, &h, sizeof( h ) );
+    return out.m_ptr - buffer;
+}
+
+bool
+ers::BinaryRecord::decode( const char * buffer, size_t size )
+{
+    if ( size < sizeof( Header ) )
+	return false;
+
+    Header h;
+    ::memcpy( &h, buffer, sizeof( h ) );
+    if ( h.version != Version || h.severity > ers::Fatal )
+	return false;
+
+    m_time = h.time;
+    m_severity = h.severity;
+    m_rank = h.rank;
+    m_pid = h.pid;
+    m_tid = h.tid;
+    m_uid = h.uid;
+    m_line = h.line;
+
+    const char * ptr = buffer + sizeof( Header );
+    const char * end = buffer + size;
+    for ( int i = 0; i < FieldsNumber; ++i )
+    {
+	if ( end - ptr < h.lengths[i] )
+	    return false;
+	m_fields[i] = std::string_view( ptr, h.lengths[i] );
+	ptr += h.lengths[i];
+    }
+    return true;
+}
+
+std::vector<std::string_view>
+ers::BinaryRecord::qualifiers() const
+{
+    std::vector<std::string_view> result;
+    const char * ptr = m_fields[Qualifiers].data();
+    const char * end = ptr + m_fields[Qualifiers].size();
+    std::string_view item;
+    while ( ptr && ptr < end && ( ptr = read_item( ptr, end, item ) ) )
+    {
+	result.push_back( item );
+    }
+    return result;
+}
+
+std::vector<std::pair<std::string_view,std::string_view> >
+ers::BinaryRecord::parameters() const
+{
+    std::vector<std::pair<std::string_view,std::string_view> > result;
+    const char * ptr = m_fields[Parameters].data();
+    const char * end = ptr + m_fields[Parameters].size();
+    std::string_view key, value;
+    while ( ptr && ptr < end
+	    && ( ptr = read_item( ptr, end, key ) )
+	    && ( ptr = read_item( ptr, end, value ) ) )
+    {
+	result.emplace_back( key, value );
+    }
+    return result;
+}
+
+ers::Issue *
+ers::BinaryRecord::to_issue() const
+{
+    const std::string host( m_fields[Host] );
+    const std::string application( m_fields[Application] );
+    const std::string package( m_fields[Package] );
+    const std::string file( m_fields[File] );
+    const std::string function( m_fields[Function] );
+
+    ers::RemoteProcessContext pc( host, m_pid, m_tid, "", m_uid, "", application );
+    ers::RemoteContext context( package, file, m_line, function, pc );
+
+    std::vector<std::string> qualifiers;
+    for ( auto & q : this->qualifiers() )
+	qualifiers.emplace_back( q );
+
+    ers::string_map parameters;
+    for ( auto & p : this->parameters() )
+	parameters.emplace( std::string( p.first ), std::string( p.second ) );
+
+    system_clock::time_point time( std::chrono::duration_cast<system_clock::duration>(
+	std::chrono::nanoseconds( m_time ) ) );
+
+    return ers::IssueFactory::instance().create( std::string( m_fields[ClassName] ), { }, context,
+	ers::Severity( (ers::severity)m_severity, m_rank ), time,
+	std::string( m_fields[Message] ), qualifiers, parameters );
+}
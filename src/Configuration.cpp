@@ -6,6 +6,10 @@
  *  Copyright 2005 CERN. All rights reserved.
  *
  */
+#include <fnmatch.h>
+#include <string.h>
+
+#include <algorithm>
 #include <cstdio>
 #include <iostream>
 
@@ -13,6 +17,7 @@
 #include <ers/ers.hpp>
 #include <ers/internal/SingletonCreator.hpp>
 #include <ers/internal/Util.hpp>
+#include <ers/internal/macro.hpp>
 
 /** This method returns the singleton instance. 
   * It should be used for every operation on the factory. 
@@ -28,26 +33,144 @@ ers::Configuration::instance()
     return *instance;
 }
 
+std::atomic<uint32_t> ers::Configuration::s_generation( 1 );
+
 /** Private constructor - can not be called by user code, use the \c instance() method instead
+  * The DUNEDAQ_ERS_DEBUG_LEVEL environment variable contains the global debug level optionally
+  * followed by comma separated list of "scope=level" items, e.g. "1,dfmodules=3,file:*Reader.cpp=5"
   * \see instance() 
+  * \see debug_level( const std::string & , int )
   */
 ers::Configuration::Configuration()
   : m_debug_level( 0 ),
-    m_verbosity_level( 0 )
+    m_verbosity_level( 0 ),
+    m_has_scopes( false )
 {
-    m_debug_level = read_from_environment( "DUNEDAQ_ERS_DEBUG_LEVEL", m_debug_level );
+    std::vector<std::string> items;
+    ers::tokenize( read_from_environment( "DUNEDAQ_ERS_DEBUG_LEVEL", "" ), ",", items );
+    for ( size_t i = 0; i < items.size(); ++i )
+    {
+	if ( items[i].empty() )
+	    continue;
+
+	std::string::size_type eq = items[i].rfind( '=' );
+	std::string value = eq == std::string::npos ? items[i] : items[i].substr( eq + 1 );
+
+	int level;
+	if ( sscanf( value.c_str(), "%d", &level ) != 1 )
+	{
+	    ERS_INTERNAL_ERROR( "Wrong value \"" << items[i]
+		    << "\" is given for the \"DUNEDAQ_ERS_DEBUG_LEVEL\" environment" )
+	    continue;
+	}
+
+	if ( eq == std::string::npos )
+	    m_debug_level = level;
+	else
+	    debug_level( items[i].substr( 0, eq ), level );
+    }
+    
     m_verbosity_level = read_from_environment( "DUNEDAQ_ERS_VERBOSITY_LEVEL", m_verbosity_level );
 }
 
+void 
+ers::Configuration::debug_level( int debug_level )
+{
+    std::unique_lock lock( m_mutex );
+    m_debug_level = debug_level;
+    ++s_generation;
+}
+
 void 
 ers::Configuration::verbosity_level( int verbosity_level )
 {
     m_verbosity_level = verbosity_level;
 }
 
+void 
+ers::Configuration::debug_level( const std::string & scope, int debug_level )
+{
+    static const std::pair<const char *, DebugScope::Kind> kinds[] = {
+	{ "package:", DebugScope::Package }, { "file:", DebugScope::File }, { "function:", DebugScope::Function } };
+
+    DebugScope s{ DebugScope::Package, scope, debug_level };
+    for ( const auto & k : kinds )
+    {
+	if ( !scope.compare( 0, ::strlen( k.first ), k.first ) )
+	{
+	    s.m_kind = k.second;
+	    s.m_pattern = scope.substr( ::strlen( k.first ) );
+	    break;
+	}
+    }
+
+    std::unique_lock lock( m_mutex );
+    // the same scope being set again goes to the end, so it takes precedence over the other ones
+    m_scopes.erase( std::remove_if( m_scopes.begin(), m_scopes.end(), [&s]( const DebugScope & d )
+	    { return d.m_kind == s.m_kind && d.m_pattern == s.m_pattern; } ), m_scopes.end() );
+    m_scopes.push_back( s );
+    m_has_scopes = true;
+    ++s_generation;
+}
+
+void 
+ers::Configuration::reset_debug_levels()
+{
+    std::unique_lock lock( m_mutex );
+    m_scopes.clear();
+    m_has_scopes = false;
+    ++s_generation;
+}
+
+int 
+ers::Configuration::debug_level( const char * package, const char * file, const char * function ) const
+{
+    if ( !m_has_scopes.load( std::memory_order_relaxed ) )
+    {
+	return debug_level();
+    }
+
+    std::shared_lock lock( m_mutex );
+    for ( auto it = m_scopes.rbegin(); it != m_scopes.rend(); ++it )
+    {
+	const char * name = it->m_kind == DebugScope::Package ? package
+			  : it->m_kind == DebugScope::File ? file : function;
+	if ( !::fnmatch( it->m_pattern.c_str(), name, 0 ) )
+	{
+	    return it->m_level;
+	}
+    }
+    return debug_level();
+}
+
+int 
+ers::Configuration::debug_level( const ers::Context & context ) const
+{
+    return debug_level( context.package_name(), context.file_name(), context.function_name() );
+}
+
+uint64_t
+ers::DebugSite::update()
+{
+    // the generation is read before the level, so a concurrent change makes the cached value outdated
+    uint64_t generation = Configuration::generation();
+    int level = Configuration::instance().debug_level( m_package, m_file, m_function );
+    uint64_t state = ( generation << 32 ) | (uint32_t)level;
+    m_state.store( state, std::memory_order_relaxed );
+    return state;
+}
+
 std::ostream & 
 ers::operator<<( std::ostream & out, const ers::Configuration & conf )
 {
-    out << "debug level = " << conf.m_debug_level << " verbosity level = " << conf.m_verbosity_level;
+    static const char * const kinds[] = { "package:", "file:", "function:" };
+
+    out << "debug level = " << conf.debug_level();
+    std::shared_lock lock( conf.m_mutex );
+    for ( const auto & s : conf.m_scopes )
+    {
+	out << "," << kinds[s.m_kind] << s.m_pattern << "=" << s.m_level;
+    }
+    out << " verbosity level = " << conf.verbosity_level();
     return out;
 }
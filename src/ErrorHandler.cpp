@@ -6,6 +6,8 @@
  *  Copyright 2005 CERN. All rights reserved.
  *
  */
+#include <unistd.h>
+
 #include <csignal>
 #include <map>
 #include <iomanip>
@@ -18,6 +20,7 @@
 #include <ers/Issue.hpp>
 #include <ers/ers.hpp>
 #include <ers/StandardStreamOutput.hpp>
+#include <ers/internal/FlightRecorder.hpp>
 
 
 ERS_DECLARE_ISSUE(	ers, 
@@ -87,6 +90,9 @@ namespace ers
         }
         recursive_invocation = true;
 
+        // the history is printed before anything else, as the heap may be already corrupted
+        FlightRecorder::dump( STDERR_FILENO );
+
         ers::SignalCatched ex( ERS_HERE_DEBUG, signal, handlers[signal]->name_.c_str());
 #ifdef __x86_64__
         if (ex.context().stack_size() > 1) {
@@ -129,6 +135,8 @@ namespace ers
             ::abort();
         }
         recursive_invocation = true;
+
+        FlightRecorder::dump( STDERR_FILENO );
             
     	try {
             throw;
@@ -0,0 +1,350 @@
+/*
+ *  FlightRecorder.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <ers/Issue.hpp>
+#include <ers/StandardStreamOutput.hpp>
+#include <ers/internal/FlightRecorder.hpp>
+#include <ers/internal/MMapRing.hpp>
+#include <ers/internal/Util.hpp>
+
+namespace
+{
+    struct Config
+    {
+	Config()
+	  : m_records( std::max( 0, ers::read_from_environment( "DUNEDAQ_ERS_FLIGHT_RECORDER", 32 ) ) ),
+	    m_debug_level( ers::read_from_environment( "DUNEDAQ_ERS_FLIGHT_RECORDER_DEBUG_LEVEL", -1 ) ),
+	    m_utc_offset( 0 )
+	{
+	    // localtime is not safe in signal handlers, so the offset is taken in advance
+	    if ( !::getenv( "DUNEDAQ_ERS_TIMESTAMP_UTC" ) )
+	    {
+		time_t now = ::time( 0 );
+		struct tm t;
+		if ( ::localtime_r( &now, &t ) )
+		    m_utc_offset = t.tm_gmtoff;
+	    }
+	}
+
+	const size_t	m_records;
+	const int	m_debug_level;
+	long		m_utc_offset;	/**< \brief local time offset in seconds used by the crash dump */
+    };
+
+    const Config & config()
+    {
+	static const Config c;
+	return c;
+    }
+
+    // Thread histories are never deleted, a history of a finished thread
+    // is kept until it is taken over by a new thread
+    struct History
+    {
+	explicit History( size_t records )
+	  : m_ring( records ),
+	    m_in_use( true ),
+	    m_next( 0 ),
+	    m_cursor( 0 ),
+	    m_end( 0 ),
+	    m_time( 0 )
+	{ ; }
+
+	ers::MMapRing		m_ring;
+	std::atomic<bool>	m_in_use;
+	History *		m_next;
+
+	// used only by the crash dump
+	uint64_t		m_cursor;	/**< \brief sequence number of the next record to be printed */
+	uint64_t		m_end;		/**< \brief sequence number after the last record to be printed */
+	int64_t			m_time;		/**< \brief time of the next record to be printed */
+    };
+
+    std::atomic<History *> s_histories( 0 );
+
+    History * acquire_history()
+    {
+	for ( History * h = s_histories.load( std::memory_order_acquire ); h; h = h->m_next )
+	{
+	    bool expected = false;
+	    if ( h->m_in_use.compare_exchange_strong( expected, true ) )
+		return h;
+	}
+
+	History * h = new History( config().m_records );
+	h->m_next = s_histories.load( std::memory_order_relaxed );
+	while ( !s_histories.compare_exchange_weak( h->m_next, h,
+		    std::memory_order_release, std::memory_order_relaxed ) )
+	    ;
+	return h;
+    }
+
+    struct ThreadHistory
+    {
+	~ThreadHistory()
+	{
+	    if ( m_history )
+		m_history->m_in_use.store( false, std::memory_order_release );
+	}
+
+	History * m_history = 0;
+    };
+
+    thread_local ThreadHistory t_history;
+
+    /** Formats a line in a fixed buffer, the text which does not fit is truncated */
+    class LineWriter
+    {
+      public:
+	LineWriter( char * buffer, size_t size )
+	  : m_begin( buffer ),
+	    m_ptr( buffer ),
+	    m_end( buffer + size - 1 )	// reserves space for the new line
+	{ ; }
+
+	LineWriter & operator<<( std::string_view s )
+	{
+	    size_t n = std::min<size_t>( s.size(), m_end - m_ptr );
+	    ::memcpy( m_ptr, s.data(), n );
+	    m_ptr += n;
+	    return *this;
+	}
+
+	LineWriter & put( int64_t value, int width = 0 )
+	{
+	    char digits[24];
+	    char * p = digits + sizeof( digits );
+	    uint64_t v = value < 0 ? -(uint64_t)value : value;
+	    do {
+		*--p = '0' + v % 10;
+		v /= 10;
+	    } while ( v || digits + sizeof( digits ) - p < width );
+	    if ( value < 0 )
+		*--p = '-';
+	    return *this << std::string_view( p, digits + sizeof( digits ) - p );
+	}
+
+	void flush( int fd )
+	{
+	    *m_ptr++ = '\n';
+	    const char * p = m_begin;
+	    while ( p < m_ptr )
+	    {
+		ssize_t n = ::write( fd, p, m_ptr - p );
+		if ( n < 0 && errno == EINTR )
+		    continue;
+		if ( n <= 0 )
+		    break;
+		p += n;
+	    }
+	    m_ptr = m_begin;
+	}
+
+      private:
+	char *		m_begin;
+	char *		m_ptr;
+	char *		m_end;
+    };
+
+    // writes the time in the default ERS format, e.g. "2026-Oct-19 18:54:32,367"
+    void put_time( LineWriter & out, int64_t ns )
+    {
+	static const char * const months[] = {
+	    "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+
+	int64_t seconds = ns / 1000000000 + config().m_utc_offset;
+	int64_t days = seconds / 86400;
+	int64_t rest = seconds % 86400;
+
+	// converts the number of days since epoch to the civil date
+	days += 719468;
+	int64_t era = ( days >= 0 ? days : days - 146096 ) / 146097;
+	int64_t doe = days - era * 146097;
+	int64_t yoe = ( doe - doe / 1460 + doe / 36524 - doe / 146096 ) / 365;
+	int64_t doy = doe - ( 365 * yoe + yoe / 4 - yoe / 100 );
+	int64_t mp = ( 5 * doy + 2 ) / 153;
+	int64_t day = doy - ( 153 * mp + 2 ) / 5 + 1;
+	int64_t month = mp < 10 ? mp + 3 : mp - 9;
+	int64_t year = yoe + era * 400 + ( month <= 2 );
+
+	out.put( year ) << "-" << months[month - 1] << "-";
+	out.put( day, 2 ) << " ";
+	out.put( rest / 3600, 2 ) << ":";
+	out.put( rest / 60 % 60, 2 ) << ":";
+	out.put( rest % 60, 2 ) << ",";
+	out.put( ns / 1000000 % 1000, 3 );
+    }
+
+    // writes the record in the same format as the standard streams with zero verbosity
+    void put_record( LineWriter & out, const ers::BinaryRecord & r )
+    {
+	static const char * const severities[] = { "DEBUG", "LOG", "INFO", "WARNING", "ERROR", "FATAL" };
+
+	out << "    [tid ";
+	out.put( r.m_tid ) << "] ";
+	put_time( out, r.m_time );
+	out << " " << severities[r.m_severity];
+	if ( r.m_severity == ers::Debug )
+	{
+	    out << "_";
+	    out.put( r.m_rank );
+	}
+	out << " [";
+
+	std::string_view function = r.m_fields[ers::BinaryRecord::Function];
+	std::string_view::size_type end = function.find( '(' );
+	if ( end != std::string_view::npos )
+	{
+	    std::string_view::size_type begin = function.rfind( ' ', end );
+	    begin = begin == std::string_view::npos ? 0 : begin + 1;
+	    out << function.substr( begin, end - begin ) << "(...)";
+	}
+	else
+	{
+	    out << function;
+	}
+
+	out << " at ";
+	std::string_view file = r.m_fields[ers::BinaryRecord::File];
+	if ( file.substr( 0, 3 ) == "../" )
+	    out << r.m_fields[ers::BinaryRecord::Package] << file.substr( 2 );
+	else
+	    out << file;
+	out << ":";
+	out.put( r.m_line ) << "] " << r.m_fields[ers::BinaryRecord::Message];
+    }
+
+    // moves the cursor to the next readable record and saves its time
+    bool advance( History & h, char * buffer, size_t size )
+    {
+	for ( ; h.m_cursor < h.m_end; ++h.m_cursor )
+	{
+	    ers::BinaryRecord record;
+	    size_t length = h.m_ring.read( h.m_cursor, buffer, size );
+	    if ( length && record.decode( buffer, length ) )
+	    {
+		h.m_time = record.m_time;
+		return true;
+	    }
+	}
+	return false;
+    }
+}
+
+void
+ers::FlightRecorder::record( const Issue & issue )
+{
+    if ( !config().m_records )
+	return;
+
+    ThreadHistory & th = t_history;
+    if ( !th.m_history )
+    {
+	try
+	{
+	    th.m_history = acquire_history();
+	}
+	catch ( std::bad_alloc & )
+	{
+	    return;
+	}
+    }
+    th.m_history->m_ring.write( issue );
+}
+
+bool
+ers::FlightRecorder::records_debug( int level )
+{
+    return config().m_records && level <= config().m_debug_level;
+}
+
+void
+ers::FlightRecorder::dump( std::ostream & out )
+{
+    std::vector<std::unique_ptr<Issue> > issues;
+    for ( History * h = s_histories.load( std::memory_order_acquire ); h; h = h->m_next )
+    {
+	h->m_ring.for_each( [&issues]( uint64_t, const BinaryRecord & record ) {
+	    issues.emplace_back( record.to_issue() );
+	} );
+    }
+
+    if ( issues.empty() )
+	return;
+
+    std::stable_sort( issues.begin(), issues.end(),
+	[]( const std::unique_ptr<Issue> & a, const std::unique_ptr<Issue> & b ) {
+	    return a->ptime() < b->ptime();
+	} );
+
+    out << "Issues recently reported by the application threads:" << std::endl;
+    for ( auto & issue : issues )
+    {
+	out << "    [tid " << issue->context().thread_id() << "] ";
+	StandardStreamOutput::println( out, *issue, 0 );
+    }
+}
+
+void
+ers::FlightRecorder::dump( int fd )
+{
+    static char record[MMapRing::SlotSize];
+    static char line[4096];
+
+    // the histories are merged by time, every one of them is already ordered
+    bool empty = true;
+    for ( History * h = s_histories.load( std::memory_order_acquire ); h; h = h->m_next )
+    {
+	uint64_t written = h->m_ring.written();
+	h->m_end = written + 1;
+	h->m_cursor = written > h->m_ring.capacity() ? written - h->m_ring.capacity() + 1 : 1;
+	empty = !advance( *h, record, sizeof( record ) ) && empty;
+    }
+
+    if ( empty )
+	return;
+
+    LineWriter out( line, sizeof( line ) );
+    out << "Issues recently reported by the application threads:";
+    out.flush( fd );
+
+    while ( true )
+    {
+	History * next = 0;
+	for ( History * h = s_histories.load( std::memory_order_acquire ); h; h = h->m_next )
+	{
+	    if ( h->m_cursor < h->m_end && ( !next || h->m_time < next->m_time ) )
+		next = h;
+	}
+
+	if ( !next )
+	    break;
+
+	BinaryRecord r;
+	size_t length = next->m_ring.read( next->m_cursor, record, sizeof( record ) );
+	if ( length && r.decode( record, length ) )
+	{
+	    put_record( out, r );
+	    out.flush( fd );
+	}
+
+	++next->m_cursor;
+	advance( *next, record, sizeof( record ) );
+    }
+}
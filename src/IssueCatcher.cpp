@@ -0,0 +1,350 @@
+/*
+ *  IssueCatcher.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <algorithm>
+
+#include <ers/internal/Hash.hpp>
+#include <ers/internal/IssueCatcher.hpp>
+
+namespace
+{
+    // issues reported by the catcher threads are not passed to the catchers again
+    thread_local bool catcher_thread = false;
+
+    uint64_t
+    site_key( const ers::Issue & issue )
+    {
+	return ers::hash_combine( ers::hash( issue.context().file_name() ), issue.context().line_number() );
+    }
+}
+
+ers::IssueCatcher::IssueCatcher(
+	const std::function<void ( const ers::Issue & )> & catcher,
+	const IssueCatcherRoute & route,
+	unsigned int threads,
+	bool ordered )
+  : m_issue_catcher( catcher ),
+    m_route( route ),
+    m_ordered( ordered && threads > 1 ),
+    m_active( false ),
+    m_head( 0 ),
+    m_sleepers( 0 ),
+    m_terminated( false ),
+    m_waiters( 0 ),
+    m_capacity( 0 ),
+    m_policy( OverflowPolicy::Block ),
+    m_threshold( ers::Error ),
+    m_pending( 0 ),
+    m_enqueued( 0 ),
+    m_dropped( 0 ),
+    m_high_water_mark( 0 )
+{
+    for ( unsigned int i = 0; i < std::max( threads, 1u ); ++i )
+    {
+	m_threads.emplace_back( &ers::IssueCatcher::thread_wrapper, this );
+    }
+    m_active.store( true, std::memory_order_release );
+}
+
+ers::IssueCatcher::~IssueCatcher()
+{
+    stop();
+}
+
+bool
+ers::IssueCatcher::in_catcher_thread()
+{
+    return catcher_thread;
+}
+
+void
+ers::IssueCatcher::stop()
+{
+    std::vector<std::thread> threads;
+    {
+	std::unique_lock lock( m_mutex );
+	if ( m_threads.empty() )
+	{
+	    return ;
+	}
+	m_active.store( false, std::memory_order_release );
+	m_terminated = true;
+	m_condition.notify_all();
+	m_space_condition.notify_all();
+	threads.swap( m_threads );
+    }
+    
+    for ( std::thread & thread : threads )
+    {
+	thread.join();
+    }
+
+    std::unique_lock lock( m_mutex );
+    take_issues();
+    for ( ; !m_issues.empty(); m_issues.pop() )
+    {
+	delete m_issues.front();
+	issue_processed();
+    }
+}
+
+/** Adds the issue to the lock-free list of new issues and wakes up a catcher thread
+  * if all of them are waiting. The mutex is used only in the latter case.
+  */
+void
+ers::IssueCatcher::push( ers::Issue * issue )
+{
+    PendingIssue * p = new PendingIssue{ issue, m_head.load( std::memory_order_relaxed ) };
+    while ( !m_head.compare_exchange_weak( p->m_next, p, std::memory_order_seq_cst, std::memory_order_relaxed ) )
+	;
+
+    // pairs with the increment of m_sleepers followed by the check of m_head in thread_wrapper
+    if ( m_sleepers.load( std::memory_order_seq_cst ) )
+    {
+	std::unique_lock lock( m_mutex );
+	m_condition.notify_one();
+    }
+}
+
+/** Moves all new issues to the m_issues queue preserving the order in which they have been reported.
+  * Must be called with the m_mutex locked.
+  */
+void
+ers::IssueCatcher::take_issues()
+{
+    PendingIssue * p = m_head.exchange( 0, std::memory_order_acquire );
+
+    PendingIssue * reversed = 0;
+    while ( p )
+    {
+	PendingIssue * next = p->m_next;
+	p->m_next = reversed;
+	reversed = p;
+	p = next;
+    }
+
+    while ( reversed )
+    {
+	PendingIssue * next = reversed->m_next;
+	m_issues.push( reversed->m_issue );
+	delete reversed;
+	reversed = next;
+    }
+}
+
+void
+ers::IssueCatcher::thread_wrapper()
+{
+    catcher_thread = true;
+    std::unique_lock lock( m_mutex );
+    while( !m_terminated )
+    {
+	take_issues();
+	if ( m_issues.empty() )
+	{
+	    m_sleepers.fetch_add( 1, std::memory_order_seq_cst );
+	    if ( !m_head.load( std::memory_order_seq_cst ) && m_issues.empty() )
+	    {
+		m_condition.wait( lock );
+	    }
+	    m_sleepers.fetch_sub( 1, std::memory_order_relaxed );
+	    continue;
+	}
+
+	// let other threads help with the batch
+	if ( m_issues.size() > 1 && m_sleepers.load( std::memory_order_relaxed ) )
+	{
+	    m_condition.notify_one();
+	}
+        
+        while( !m_terminated && !m_issues.empty() )
+        {
+            ers::Issue * issue = m_issues.front();
+            m_issues.pop();
+            process_issue( lock, issue );
+        }
+    }
+}
+
+/** Passes the issue to the catcher. If the issues have to be ordered and another thread
+  * is processing an issue reported at the same place, the issue is handed over to that thread.
+  * \param lock the lock of the m_mutex, which is released while the catcher is running
+  * \param issue the issue to be processed
+  */
+void
+ers::IssueCatcher::process_issue( std::unique_lock<std::mutex> & lock, ers::Issue * issue )
+{
+    if ( !m_ordered )
+    {
+	lock.unlock();
+	m_issue_catcher( *issue );
+	delete issue;
+	lock.lock();
+	issue_processed();
+	return ;
+    }
+
+    uint64_t key = site_key( *issue );
+    auto it = m_busy_sites.find( key );
+    if ( it != m_busy_sites.end() )
+    {
+	it->second.push( issue );
+	return ;
+    }
+
+    std::queue<ers::Issue *> & pending = m_busy_sites[key];
+    while ( issue )
+    {
+	lock.unlock();
+	m_issue_catcher( *issue );
+	delete issue;
+	lock.lock();
+	issue_processed();
+
+	issue = 0;
+	if ( !m_terminated && !pending.empty() )
+	{
+	    issue = pending.front();
+	    pending.pop();
+	}
+    }
+
+    for ( ; !pending.empty(); pending.pop() )
+    {
+	delete pending.front();
+	issue_processed();
+    }
+    m_busy_sites.erase( key );
+}
+
+/** Must be called with the m_mutex locked for every issue taken from the queue */
+void
+ers::IssueCatcher::issue_processed()
+{
+    m_pending.fetch_sub( 1, std::memory_order_relaxed );
+    if ( m_waiters )
+    {
+	m_space_condition.notify_all();
+    }
+}
+
+void
+ers::IssueCatcher::update_high_water_mark( size_t pending )
+{
+    size_t mark = m_high_water_mark.load( std::memory_order_relaxed );
+    while ( mark < pending
+	&& !m_high_water_mark.compare_exchange_weak( mark, pending, std::memory_order_relaxed ) )
+	;
+}
+
+void
+ers::IssueCatcher::set_queue_limit( size_t capacity, OverflowPolicy policy, ers::severity threshold )
+{
+    std::unique_lock lock( m_mutex );
+    m_capacity = capacity;
+    m_policy = policy;
+    m_threshold = threshold;
+    m_space_condition.notify_all();
+}
+
+void
+ers::IssueCatcher::add_statistics( LocalStreamStatistics & statistics ) const
+{
+    statistics.enqueued += m_enqueued.load( std::memory_order_relaxed );
+    statistics.dropped += m_dropped.load( std::memory_order_relaxed );
+    statistics.high_water_mark = std::max( statistics.high_water_mark, m_high_water_mark.load( std::memory_order_relaxed ) );
+    statistics.pending += m_pending.load( std::memory_order_relaxed );
+}
+
+bool
+ers::IssueCatcher::wait_until_drained( const std::chrono::steady_clock::time_point & deadline )
+{
+    std::unique_lock lock( m_mutex );
+    ++m_waiters;
+    bool drained = m_space_condition.wait_until( lock, deadline, [this](){ return !m_pending; } );
+    --m_waiters;
+    return drained;
+}
+
+/** Reserves a place for a new issue in the queue. The fast path does not use the mutex,
+  * which is locked only if the queue is full to apply the overflow policy.
+  */
+ers::IssueCatcher::Admission
+ers::IssueCatcher::admit( ers::severity type )
+{
+    size_t capacity = m_capacity.load( std::memory_order_relaxed );
+    size_t pending = m_pending.fetch_add( 1, std::memory_order_relaxed ) + 1;
+    if ( !capacity || pending <= capacity )
+    {
+	update_high_water_mark( pending );
+	m_enqueued.fetch_add( 1, std::memory_order_relaxed );
+	return Admission::Accepted;
+    }
+    m_pending.fetch_sub( 1, std::memory_order_relaxed );
+
+    std::unique_lock lock( m_mutex );
+    if ( m_policy == OverflowPolicy::DropOldest )
+    {
+	take_issues();
+	if ( !m_issues.empty() )
+	{
+	    // the new issue takes the place of the dropped one
+	    delete m_issues.front();
+	    m_issues.pop();
+	    m_dropped.fetch_add( 1, std::memory_order_relaxed );
+	    m_enqueued.fetch_add( 1, std::memory_order_relaxed );
+	    return Admission::Accepted;
+	}
+    }
+    else if ( m_policy == OverflowPolicy::Block
+	|| ( m_policy == OverflowPolicy::DropBelowSeverity && type >= m_threshold ) )
+    {
+	++m_waiters;
+	while ( m_active.load( std::memory_order_relaxed ) )
+	{
+	    capacity = m_capacity.load( std::memory_order_relaxed );
+	    pending = m_pending.fetch_add( 1, std::memory_order_relaxed ) + 1;
+	    if ( !capacity || pending <= capacity )
+	    {
+		--m_waiters;
+		update_high_water_mark( pending );
+		m_enqueued.fetch_add( 1, std::memory_order_relaxed );
+		return Admission::Accepted;
+	    }
+	    m_pending.fetch_sub( 1, std::memory_order_relaxed );
+	    m_space_condition.wait( lock );
+	}
+	// the catcher has been removed while we were waiting
+	--m_waiters;
+	return Admission::NoCatcher;
+    }
+
+    m_dropped.fetch_add( 1, std::memory_order_relaxed );
+    return Admission::Dropped;
+}
+
+bool
+ers::IssueCatcher::report( const ers::Issue & issue )
+{
+    if ( !m_active.load( std::memory_order_acquire ) )
+    {
+	return false;
+    }
+
+    switch ( admit( issue.severity().type ) )
+    {
+	case Admission::Accepted:
+	    push( issue.clone() );
+	    return true;
+	case Admission::Dropped:
+	    return true;
+	case Admission::NoCatcher:
+	default:
+	    return false;
+    }
+}
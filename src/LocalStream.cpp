@@ -6,9 +6,43 @@
  *  Copyright 2005 CERN. All rights reserved.
  *
  */
+#include <algorithm>
+
 #include <ers/LocalStream.hpp>
 #include <ers/StreamManager.hpp>
+#include <ers/internal/FlightRecorder.hpp>
+#include <ers/internal/IssueCatcher.hpp>
 #include <ers/internal/SingletonCreator.hpp>
+#include <ers/internal/Util.hpp>
+#include <ers/internal/macro.hpp>
+
+ers::IssueCatcherRoute
+ers::route_severity( ers::severity severity )
+{
+    return [severity]( const ers::Issue & issue ) { return issue.severity().type == severity; };
+}
+
+ers::IssueCatcherRoute
+ers::route_class( const std::string & class_name )
+{
+    return [class_name]( const ers::Issue & issue )
+    {
+	if ( class_name == issue.get_class_name() )
+	    return true;
+	ers::inheritance_type chain = issue.get_class_inheritance();
+	return std::find( chain.begin(), chain.end(), class_name ) != chain.end();
+    };
+}
+
+ers::IssueCatcherRoute
+ers::route_qualifier( const std::string & qualifier )
+{
+    return [qualifier]( const ers::Issue & issue )
+    {
+	const std::vector<std::string> & qualifiers = issue.qualifiers();
+	return std::find( qualifiers.begin(), qualifiers.end(), qualifier ) != qualifiers.end();
+    };
+}
 
 /** This method returns the singleton instance.
   * It should be used for every operation on the factory.
@@ -28,82 +62,233 @@ ers::LocalStream::instance()
   * \see instance()
   */
 ers::LocalStream::LocalStream( )
-  : m_terminated( false )
-{ }
+  : m_capacity( 0 ),
+    m_policy( OverflowPolicy::Block ),
+    m_threshold( ers::Error )
+{
+    const char * env = ers::read_from_environment( "DUNEDAQ_ERS_LOCAL_QUEUE", (const char *)0 );
+    if ( !env )
+    {
+	return ;
+    }
+
+    std::vector<std::string> params;
+    ers::tokenize( env, ",", params );
+
+    static const std::pair<const char *, OverflowPolicy> policies[] = {
+	{ "block", OverflowPolicy::Block }, { "drop-newest", OverflowPolicy::DropNewest },
+	{ "drop-oldest", OverflowPolicy::DropOldest }, { "drop-below-severity", OverflowPolicy::DropBelowSeverity } };
+
+    OverflowPolicy policy = OverflowPolicy::Block;
+    if ( params.size() > 1 )
+    {
+	auto it = std::find_if( std::begin( policies ), std::end( policies ),
+		[&params]( const auto & p ) { return params[1] == p.first; } );
+	if ( it != std::end( policies ) )
+	    policy = it->second;
+	else
+	    ERS_INTERNAL_WARNING( "Unknown local queue overflow policy \"" << params[1] << "\", \"block\" will be used" )
+    }
+
+    ers::severity threshold = ers::Error;
+    if ( params.size() > 2 )
+    {
+	try
+	{
+	    ers::parse( params[2], threshold );
+	}
+	catch ( ers::Issue & ex )
+	{
+	    ERS_INTERNAL_WARNING( "Unknown severity \"" << params[2] << "\", \"ERROR\" will be used" )
+	}
+    }
+
+    m_capacity = params.empty() ? 0 : ers::parse_size( params[0], 0 );
+    m_policy = policy;
+    m_threshold = threshold;
+}
 
 ers::LocalStream::~LocalStream( )
 {
-    remove_issue_catcher();
+    std::shared_ptr<const Catchers> catchers = this->catchers();
+    if ( catchers )
+    {
+	for ( const auto & c : *catchers )
+	{
+	    c->stop();
+	}
+    }
+}
+
+std::shared_ptr<const ers::LocalStream::Catchers>
+ers::LocalStream::catchers() const
+{
+    return std::atomic_load( &m_catchers );
+}
+
+ers::IssueCatcherHandler *
+ers::LocalStream::set_issue_catcher( 
+	const std::function<void ( const ers::Issue & )> & catcher,
+	unsigned int threads,
+	bool ordered )
+{
+    return add_issue_catcher( std::make_shared<IssueCatcher>( catcher, IssueCatcherRoute(), threads, ordered ) );
+}
+
+ers::IssueCatcherHandler *
+ers::LocalStream::add_issue_catcher( 
+	const std::function<void ( const ers::Issue & )> & catcher,
+	const IssueCatcherRoute & route,
+	unsigned int threads,
+	bool ordered )
+{
+    return add_issue_catcher( std::make_shared<IssueCatcher>( catcher, route, threads, ordered ) );
+}
+
+ers::IssueCatcherHandler *
+ers::LocalStream::add_issue_catcher( const std::shared_ptr<IssueCatcher> & catcher )
+{
+    std::unique_lock lock( m_mutex );
+    if ( !catcher->has_route() )
+    {
+	// only one catcher can receive all issues
+	std::shared_ptr<const Catchers> catchers = this->catchers();
+	if ( catchers && std::any_of( catchers->begin(), catchers->end(),
+				[]( const auto & c ) { return !c->has_route(); } ) )
+	{
+	    lock.unlock();
+	    catcher->stop();
+	    throw ers::IssueCatcherAlreadySet( ERS_HERE );
+	}
+    }
+
+    catcher->set_queue_limit( m_capacity, m_policy, m_threshold );
+
+    std::shared_ptr<const Catchers> old = catchers();
+    auto updated = std::make_shared<Catchers>( old ? *old : Catchers() );
+    updated->push_back( catcher );
+    std::atomic_store( &m_catchers, std::shared_ptr<const Catchers>( updated ) );
+    
+    return new ers::IssueCatcherHandler( catcher.get() );
 }
 
 void
-ers::LocalStream::remove_issue_catcher( )
+ers::LocalStream::remove_issue_catcher( IssueCatcher * catcher )
 {
-    std::unique_ptr<std::thread> catcher;
+    std::shared_ptr<IssueCatcher> removed;
     {
 	std::unique_lock lock( m_mutex );
-	if ( !m_issue_catcher_thread.get() )
+	std::shared_ptr<const Catchers> old = catchers();
+	if ( !old )
 	{
 	    return ;
 	}
-	m_terminated = true;
-	m_condition.notify_one();
-	catcher.swap(m_issue_catcher_thread);
+
+	auto updated = std::make_shared<Catchers>();
+	for ( const auto & c : *old )
+	{
+	    if ( c.get() == catcher )
+		removed = c;
+	    else
+		updated->push_back( c );
+	}
+	std::atomic_store( &m_catchers, updated->empty()
+		? std::shared_ptr<const Catchers>() : std::shared_ptr<const Catchers>( updated ) );
+    }
+
+    if ( removed )
+    {
+	removed->stop();
     }
-    
-    catcher -> join();
 }
 
 void
-ers::LocalStream::thread_wrapper()
+ers::LocalStream::set_queue_limit( size_t capacity, OverflowPolicy policy, ers::severity threshold )
 {
     std::unique_lock lock( m_mutex );
-    m_catcher_thread_id = std::this_thread::get_id();
-    while( !m_terminated )
+    m_capacity = capacity;
+    m_policy = policy;
+    m_threshold = threshold;
+
+    std::shared_ptr<const Catchers> catchers = this->catchers();
+    if ( catchers )
     {
-	m_condition.wait( lock, [this](){return !m_issues.empty() || m_terminated;} );
-        
-        while( !m_terminated && !m_issues.empty() )
-        {
-            ers::Issue * issue = m_issues.front();
-            m_issues.pop();
-            
-            lock.unlock();            
-            m_issue_catcher( *issue );
-	    delete issue;
-            lock.lock();            
-        }
+	for ( const auto & c : *catchers )
+	{
+	    c->set_queue_limit( capacity, policy, threshold );
+	}
     }
-    m_catcher_thread_id = {};
-    m_terminated = false;
 }
 
-ers::IssueCatcherHandler *
-ers::LocalStream::set_issue_catcher( const std::function<void ( const ers::Issue & )> & catcher )
+ers::LocalStreamStatistics
+ers::LocalStream::statistics()
 {
-    std::unique_lock lock( m_mutex );
-    if ( m_issue_catcher_thread.get() )
+    LocalStreamStatistics statistics{ 0, 0, 0, 0 };
+    std::shared_ptr<const Catchers> catchers = this->catchers();
+    if ( catchers )
+    {
+	for ( const auto & c : *catchers )
+	{
+	    c->add_statistics( statistics );
+	}
+    }
+    return statistics;
+}
+
+void
+ers::LocalStream::wait_until_drained()
+{
+    wait_until_drained( std::chrono::milliseconds::max() );
+}
+
+bool
+ers::LocalStream::wait_until_drained( std::chrono::milliseconds timeout )
+{
+    auto now = std::chrono::steady_clock::now();
+    auto deadline = timeout >= std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::steady_clock::time_point::max() - now )
+	    ? std::chrono::steady_clock::time_point::max() : now + timeout;
+
+    bool drained = true;
+    std::shared_ptr<const Catchers> catchers = this->catchers();
+    if ( catchers )
     {
-    	throw ers::IssueCatcherAlreadySet( ERS_HERE );
+	for ( const auto & c : *catchers )
+	{
+	    drained = c->wait_until_drained( deadline ) && drained;
+	}
     }
-    m_issue_catcher = catcher;
-    m_issue_catcher_thread.reset( new std::thread( std::bind( &ers::LocalStream::thread_wrapper, this ) ) );
-    
-    return new ers::IssueCatcherHandler;
+    return drained;
 }
 
 void 
 ers::LocalStream::report_issue( ers::severity type, const ers::Issue & issue )
 {
-    if ( m_issue_catcher_thread.get() && m_catcher_thread_id != std::this_thread::get_id() )
+    std::shared_ptr<const Catchers> catchers;
+    if ( !IssueCatcher::in_catcher_thread() )
     {
-	ers::Issue * clone = issue.clone();
-	clone->set_severity( type );
-	std::unique_lock lock( m_mutex );
-	m_issues.push( clone );
-	m_condition.notify_one();
+	catchers = this->catchers();
     }
-    else
+
+    bool reported = false;
+    if ( catchers )
+    {
+	ers::severity old_severity = issue.set_severity( type );
+	for ( const auto & c : *catchers )
+	{
+	    if ( c->accepts( issue ) && c->report( issue ) )
+	    {
+		reported = true;
+	    }
+	}
+	if ( reported )
+	{
+	    FlightRecorder::record( issue );
+	}
+	issue.set_severity( old_severity );
+    }
+
+    if ( !reported )
     {
 	StreamManager::instance().report_issue( type, issue );
     }
@@ -0,0 +1,235 @@
+/*
+ *  MMapRing.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <vector>
+
+#include <ers/SampleIssues.hpp>
+#include <ers/internal/MMapRing.hpp>
+
+namespace
+{
+    const char Magic[8] = { 'E', 'R', 'S', 'R', 'I', 'N', 'G', '1' };
+    const size_t HeaderSize = 4096;
+}
+
+struct ers::MMapRing::Header
+{
+    char			magic[8];
+    uint32_t			slot_size;
+    uint32_t			version;
+    uint64_t			slots_number;
+    std::atomic<uint64_t>	next;
+};
+
+struct ers::MMapRing::Slot
+{
+    std::atomic<uint64_t>	sequence;	/**< \brief 0 means the slot is empty or being written */
+    uint32_t			length;
+    char			data[SlotSize - sizeof( std::atomic<uint64_t> ) - sizeof( uint32_t )];
+};
+
+ers::MMapRing::MMapRing( const std::string & file_name, size_t size )
+  : m_address( MAP_FAILED ),
+    m_size( std::max( size - size % SlotSize, HeaderSize + SlotSize ) ),
+    m_header( 0 ),
+    m_slots_number( 0 )
+{
+    int fd = ::open( file_name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644 );
+    if ( fd < 0 )
+    {
+	throw ers::CantOpenFile( ERS_HERE, file_name.c_str() );
+    }
+
+    // serialize layout initialization with other processes that may open the same file
+    ::flock( fd, LOCK_EX );
+
+    struct stat st;
+    bool reuse = false;
+    if ( !::fstat( fd, &st ) && (size_t)st.st_size == m_size )
+    {
+	struct { char magic[8]; uint32_t slot_size; uint32_t version; uint64_t slots_number; } h;
+	reuse = ::pread( fd, &h, sizeof( h ), 0 ) == sizeof( h )
+		&& !::memcmp( h.magic, Magic, sizeof( Magic ) )
+		&& h.slot_size == SlotSize
+		&& h.version == BinaryRecord::Version
+		&& h.slots_number == ( m_size - HeaderSize ) / SlotSize;
+    }
+
+    if ( !reuse && ( ::ftruncate( fd, 0 ) || ::ftruncate( fd, m_size ) ) )
+    {
+	::close( fd );
+	throw ers::CantOpenFile( ERS_HERE, file_name.c_str() );
+    }
+
+    map( file_name, fd, m_size, true );
+
+    if ( !reuse )
+    {
+	m_header->slot_size = SlotSize;
+	m_header->version = BinaryRecord::Version;
+	m_header->slots_number = m_slots_number;
+	m_header->next.store( 0 );
+	::memcpy( m_header->magic, Magic, sizeof( Magic ) );
+    }
+
+    ::flock( fd, LOCK_UN );
+    ::close( fd );
+}
+
+ers::MMapRing::MMapRing( const std::string & file_name )
+  : m_address( MAP_FAILED ),
+    m_size( 0 ),
+    m_header( 0 ),
+    m_slots_number( 0 )
+{
+    int fd = ::open( file_name.c_str(), O_RDONLY | O_CLOEXEC );
+    struct stat st;
+    if ( fd < 0 || ::fstat( fd, &st ) || (size_t)st.st_size < HeaderSize + SlotSize )
+    {
+	if ( fd >= 0 )
+	    ::close( fd );
+	throw ers::CantOpenFile( ERS_HERE, file_name.c_str() );
+    }
+
+    m_size = st.st_size;
+    map( file_name, fd, m_size, false );
+    ::close( fd );
+
+    if (    ::memcmp( m_header->magic, Magic, sizeof( Magic ) )
+	 || m_header->slot_size != SlotSize
+	 || m_header->slots_number != m_slots_number )
+    {
+	::munmap( m_address, m_size );
+	throw ers::CantOpenFile( ERS_HERE, file_name.c_str() );
+    }
+}
+
+ers::MMapRing::MMapRing( size_t records )
+  : m_address( MAP_FAILED ),
+    m_size( HeaderSize + std::max<size_t>( records, 1 ) * SlotSize ),
+    m_header( 0 ),
+    m_slots_number( 0 )
+{
+    m_address = ::mmap( 0, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    if ( m_address == MAP_FAILED )
+    {
+	throw std::bad_alloc();
+    }
+    m_header = static_cast<Header *>( m_address );
+    m_slots_number = ( m_size - HeaderSize ) / SlotSize;
+    m_header->slot_size = SlotSize;
+    m_header->version = BinaryRecord::Version;
+    m_header->slots_number = m_slots_number;
+    ::memcpy( m_header->magic, Magic, sizeof( Magic ) );
+}
+
+ers::MMapRing::~MMapRing()
+{
+    if ( m_address != MAP_FAILED )
+    {
+	::munmap( m_address, m_size );
+    }
+}
+
+void
+ers::MMapRing::map( const std::string & file_name, int fd, size_t size, bool writable )
+{
+    m_address = ::mmap( 0, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0 );
+    if ( m_address == MAP_FAILED )
+    {
+	::close( fd );
+	throw ers::CantOpenFile( ERS_HERE, file_name.c_str() );
+    }
+    m_header = static_cast<Header *>( m_address );
+    m_slots_number = ( size - HeaderSize ) / SlotSize;
+}
+
+ers::MMapRing::Slot &
+ers::MMapRing::slot( uint64_t sequence ) const
+{
+    static_assert( sizeof( Slot ) == SlotSize, "wrong slot size" );
+    static_assert( std::atomic<uint64_t>::is_always_lock_free, "shared memory requires lock-free atomics" );
+
+    char * slots = static_cast<char *>( m_address ) + HeaderSize;
+    return *reinterpret_cast<Slot *>( slots + ( ( sequence - 1 ) % m_slots_number ) * SlotSize );
+}
+
+uint64_t
+ers::MMapRing::written() const
+{
+    return m_header->next.load( std::memory_order_relaxed );
+}
+
+size_t
+ers::MMapRing::read( uint64_t sequence, char * buffer, size_t size ) const
+{
+    const Slot & s = slot( sequence );
+    if ( s.sequence.load( std::memory_order_acquire ) != sequence )
+	return 0;
+
+    size_t length = std::min<size_t>( std::min<size_t>( s.length, sizeof( s.data ) ), size );
+    ::memcpy( buffer, s.data, length );
+    std::atomic_thread_fence( std::memory_order_acquire );
+
+    // the slot may have been overwritten while being copied
+    return s.sequence.load( std::memory_order_relaxed ) == sequence ? length : 0;
+}
+
+void
+ers::MMapRing::write( const Issue & issue )
+{
+    uint64_t sequence = m_header->next.fetch_add( 1, std::memory_order_relaxed ) + 1;
+    Slot & s = slot( sequence );
+
+    s.sequence.store( 0, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+
+    s.length = BinaryRecord::encode( issue, s.data, sizeof( s.data ) );
+    s.sequence.store( sequence, std::memory_order_release );
+}
+
+void
+ers::MMapRing::for_each( const std::function<void ( uint64_t , const BinaryRecord & )> & f ) const
+{
+    std::vector<std::pair<uint64_t, const Slot *> > slots;
+    slots.reserve( m_slots_number );
+    for ( size_t i = 0; i < m_slots_number; ++i )
+    {
+	const Slot & s = slot( i + 1 );
+	uint64_t sequence = s.sequence.load( std::memory_order_acquire );
+	if ( sequence )
+	    slots.emplace_back( sequence, &s );
+    }
+    std::sort( slots.begin(), slots.end() );
+
+    char buffer[sizeof( Slot::data )];
+    for ( auto & s : slots )
+    {
+	uint32_t length = std::min<uint32_t>( s.second->length, sizeof( buffer ) );
+	::memcpy( buffer, s.second->data, length );
+	std::atomic_thread_fence( std::memory_order_acquire );
+
+	// skip the slot if it has been overwritten while being copied
+	if ( s.second->sequence.load( std::memory_order_relaxed ) != s.first )
+	    continue;
+
+	BinaryRecord record;
+	if ( record.decode( buffer, length ) )
+	    f( s.first, record );
+    }
+}
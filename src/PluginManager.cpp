@@ -11,8 +11,46 @@
 namespace
 {
     const char * const SEPARATOR = ":";
-    const char * const DefaultLibraryName = "ers_AbortStream_ersStream:ers_ExitStream_ersStream:ers_FilterStream_ersStream:ers_GlobalLockStream_ersStream:ers_LockStream_ersStream:ers_NullStream_ersStream:ers_RFilterStream_ersStream:ers_StandardStream_ersStream:ers_ThrottleStream_ersStream:ers_ThrowStream_ersStream";
     const char * const EnvironmentName = "DUNEDAQ_ERS_STREAM_LIBS";
+
+    // Streams implemented by the ERS plugins, which are loaded only when one of their streams is used.
+    // If the ERS library is built with the streams linked in, they are registered before being looked up here.
+    const std::pair<const char *, const char *> BuiltinManifest[] =
+    {
+	{ "abort",	"ers_AbortStream_ersStream" },
+	{ "aggregate",	"ers_AggregateStream_ersStream" },
+	{ "udp",	"ers_DatagramStream_ersStream" },
+	{ "unix",	"ers_DatagramStream_ersStream" },
+	{ "exit",	"ers_ExitStream_ersStream" },
+	{ "filter",	"ers_FilterStream_ersStream" },
+	{ "glock",	"ers_GlobalLockStream_ersStream" },
+	{ "journal",	"ers_JournalStream_ersStream" },
+	{ "lock",	"ers_LockStream_ersStream" },
+	{ "mmapring",	"ers_MMapRingStream_ersStream" },
+	{ "null",	"ers_NullStream_ersStream" },
+	{ "protofile",	"ers_ProtoFileStream_ersStream" },
+	{ "ratelimit",	"ers_RateLimitStream_ersStream" },
+	{ "rfilter",	"ers_RFilterStream_ersStream" },
+	{ "rfile",	"ers_RotatingFileStream_ersStream" },
+	{ "shm",	"ers_SharedMemoryStream_ersStream" },
+	{ "file",	"ers_StandardStream_ersStream" },
+	{ "stdout",	"ers_StandardStream_ersStream" },
+	{ "stderr",	"ers_StandardStream_ersStream" },
+	{ "lfile",	"ers_StandardStream_ersStream" },
+	{ "afile",	"ers_StandardStream_ersStream" },
+	{ "lstdout",	"ers_StandardStream_ersStream" },
+	{ "lstderr",	"ers_StandardStream_ersStream" },
+	{ "ffile",	"ers_StandardStream_ersStream" },
+	{ "fstdout",	"ers_StandardStream_ersStream" },
+	{ "fstderr",	"ers_StandardStream_ersStream" },
+	{ "lffile",	"ers_StandardStream_ersStream" },
+	{ "affile",	"ers_StandardStream_ersStream" },
+	{ "lfstdout",	"ers_StandardStream_ersStream" },
+	{ "lfstderr",	"ers_StandardStream_ersStream" },
+	{ "throttle",	"ers_ThrottleStream_ersStream" },
+	{ "throw",	"ers_ThrowStream_ersStream" },
+	{ "where",	"ers_WhereStream_ersStream" }
+    };
 }
 
 namespace ers
@@ -54,29 +92,85 @@ namespace ers
 	}
     }
 
+    /** The DUNEDAQ_ERS_STREAM_LIBS environment variable contains a colon separated list of libraries.
+      * Each library may be preceded by a comma separated list of the streams it implements,
+      * e.g. "mystream,otherstream=MyStreams:MyFilter". A library given without stream names
+      * is loaded when a stream, which is not in the manifest, is used for the first time.
+      */
     PluginManager::PluginManager( )
     {
+	for ( const auto & m : BuiltinManifest )
+	{
+	    manifest_[m.first] = m.second;
+	}
+
 	const char * env = ::getenv( EnvironmentName );
-        std::string config( env ? std::string( env ) + SEPARATOR + DefaultLibraryName : DefaultLibraryName );
-        
-        std::vector<std::string> libs;
-    	ers::tokenize( config, SEPARATOR, libs );
-        
-        
+	if ( !env )
+	{
+	    return ;
+	}
+
+	std::vector<std::string> libs;
+	ers::tokenize( env, SEPARATOR, libs );
+
 	for ( size_t i = 0; i < libs.size(); i++ )
 	{
-	    LibMap::iterator it = libraries_.find( libs[i] );
-	    if ( it == libraries_.end() )
+	    std::string::size_type eq = libs[i].find( '=' );
+	    if ( eq == std::string::npos )
+	    {
+		unmapped_.push_back( libs[i] );
+		continue;
+	    }
+
+	    std::string library = libs[i].substr( eq + 1 );
+	    std::vector<std::string> streams;
+	    ers::tokenize( libs[i].substr( 0, eq ), ",", streams );
+	    for ( size_t j = 0; j < streams.size(); j++ )
 	    {
-		try
-                {
-                    libraries_[libs[i]] = new SharedLibrary( libs[i] );
-                }
-                catch( PluginException & ex )
-                {
-		    ERS_INTERNAL_ERROR( "Library " << libs[i] << " can not be loaded because " << ex.reason() )
-                }
+		manifest_[streams[j]] = library;
 	    }
 	}
     }
+
+    bool
+    PluginManager::load( const std::string & stream )
+    {
+	std::scoped_lock lock( mutex_ );
+
+	Manifest::iterator it = manifest_.find( stream );
+	if ( it != manifest_.end() )
+	{
+	    return load_library( it->second );
+	}
+
+	bool loaded = false;
+	for ( size_t i = 0; i < unmapped_.size(); i++ )
+	{
+	    loaded = load_library( unmapped_[i] ) || loaded;
+	}
+	return loaded;
+    }
+
+    bool
+    PluginManager::load_library( const std::string & name )
+    {
+	LibMap::iterator it = libraries_.find( name );
+	if ( it != libraries_.end() )
+	{
+	    return false;
+	}
+
+	// a library, which failed to load, is not tried again
+	SharedLibrary * library = 0;
+	try
+	{
+	    library = new SharedLibrary( name );
+	}
+	catch( PluginException & ex )
+	{
+	    ERS_INTERNAL_ERROR( "Library " << name << " can not be loaded because " << ex.reason() )
+	}
+	libraries_[name] = library;
+	return library != 0;
+    }
 }
@@ -1,4 +1,6 @@
 #include <ers/Schema.hpp>
+#include <ers/IssueFactory.hpp>
+#include <ers/RemoteContext.hpp>
 
 
  // converters with allocation                                                                                       
@@ -64,6 +66,10 @@ void ers::to_schema ( const Issue & i,   dunedaq::ersschema::SimpleIssue & out)
   for ( auto p : i.parameters() ) {
     params[p.first] = p.second;
   }
+
+  for ( auto & q : i.qualifiers() ) {
+    out.add_qualifiers(q);
+  }
   
 }
 
@@ -82,3 +88,36 @@ void ers::to_schema ( const Issue & i,   dunedaq::ersschema::IssueChain & out) {
 
   }
 
+
+std::unique_ptr<ers::Issue> ers::from_schema( const dunedaq::ersschema::SimpleIssue & i, const Issue * cause ) {
+
+  auto & c = i.context();
+  ers::RemoteProcessContext pc( c.host_name(), c.process_id(), c.thread_id(),
+                                c.cwd(), c.user_id(), c.user_name(), c.application_name() );
+  ers::RemoteContext context( c.package_name(), c.file_name(), c.line_number(), c.function_name(), pc );
+
+  std::list<std::string> inheritance( i.inheritance().begin(), i.inheritance().end() );
+  std::vector<std::string> qualifiers( i.qualifiers().begin(), i.qualifiers().end() );
+  ers::string_map parameters( i.parameters().begin(), i.parameters().end() );
+
+  ers::Severity severity( ers::Information );
+  ers::parse( i.severity(), severity );
+
+  system_clock::time_point time( std::chrono::duration_cast<system_clock::duration>(
+    std::chrono::nanoseconds( i.time() ) ) );
+
+  return std::unique_ptr<Issue>( ers::IssueFactory::instance().create(
+    i.name(), inheritance, context, severity, time, i.message(), qualifiers, parameters, cause ) );
+}
+
+
+std::unique_ptr<ers::Issue> ers::from_schema( const dunedaq::ersschema::IssueChain & chain ) {
+
+  // the last cause in the chain is the root one
+  std::unique_ptr<Issue> cause;
+  for ( auto it = chain.causes().rbegin(); it != chain.causes().rend(); ++it ) {
+    cause = from_schema( *it, cause.release() );
+  }
+
+  return from_schema( chain.final(), cause.release() );
+}
@@ -0,0 +1,338 @@
+/*
+ *  SharedMemoryQueue.cxx
+ *  ers
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+#include <ers/SampleIssues.hpp>
+#include <ers/Schema.hpp>
+#include <ers/internal/SharedMemoryQueue.hpp>
+
+namespace
+{
+    const char Magic[8] = { 'E', 'R', 'S', 'S', 'H', 'M', 'Q', '1' };
+    const uint32_t Version = 1;
+    const size_t HeaderSize = 4096;
+    const size_t MinSlotSize = 256;
+    const std::chrono::seconds StuckTimeout( 1 );
+
+    void futex_wait( std::atomic<uint32_t> & word, uint32_t value, std::chrono::milliseconds timeout )
+    {
+	struct timespec ts;
+	ts.tv_sec = timeout.count() / 1000;
+	ts.tv_nsec = ( timeout.count() % 1000 ) * 1000000;
+	::syscall( SYS_futex, &word, FUTEX_WAIT, value, &ts, 0, 0 );
+    }
+
+    void futex_wake( std::atomic<uint32_t> & word )
+    {
+	::syscall( SYS_futex, &word, FUTEX_WAKE, 1, 0, 0, 0 );
+    }
+}
+
+struct ers::SharedMemoryQueue::Header
+{
+    char			magic[8];
+    uint32_t			slot_size;
+    uint32_t			version;
+    uint64_t			slots_number;
+
+    alignas( 64 ) std::atomic<uint64_t>	tail;		/**< \brief next position to be reserved by a producer */
+    std::atomic<uint64_t>		dropped;
+    alignas( 64 ) std::atomic<uint64_t>	head;		/**< \brief next position to be read by the consumer */
+    alignas( 64 ) std::atomic<uint32_t>	waiting;	/**< \brief the consumer is going to sleep */
+    std::atomic<uint32_t>		signal;		/**< \brief futex word used for waking up the consumer */
+};
+
+/** A slot at position P is free for the producer if its sequence is equal to P
+  * and is ready for the consumer if its sequence is equal to P + 1
+  */
+struct ers::SharedMemoryQueue::Slot
+{
+    std::atomic<uint64_t>	sequence;
+    uint32_t			length;
+    char			data[4];
+};
+
+ers::SharedMemoryQueue::SharedMemoryQueue( const std::string & name, size_t size, size_t slot_size, bool consumer,
+					  mode_t mode )
+  : m_name( !name.empty() && name[0] == '/' ? name : '/' + name ),
+    m_fd( -1 ),
+    m_address( MAP_FAILED ),
+    m_size( 0 ),
+    m_header( 0 ),
+    m_slot_size( 0 ),
+    m_slots_number( 0 ),
+    m_stuck_position( 0 )
+{
+    static_assert( sizeof( Header ) <= HeaderSize, "wrong header size" );
+    static_assert( std::atomic<uint64_t>::is_always_lock_free, "shared memory requires lock-free atomics" );
+
+    mode &= 0777;
+    m_fd = ::shm_open( m_name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, mode );
+    if ( m_fd < 0 )
+    {
+	throw ers::CantOpenFile( ERS_HERE, m_name.c_str() );
+    }
+
+    // the content of the object drives the consumer, so nobody else may be able to modify it
+    struct stat owner;
+    if ( ::fstat( m_fd, &owner ) )
+    {
+	::close( m_fd );
+	throw ers::CantOpenFile( ERS_HERE, m_name.c_str() );
+    }
+
+    if ( owner.st_uid == ::geteuid() )
+    {
+	// the mode of the new object is restricted by umask, the existing one may have a wrong mode
+	if ( ( owner.st_mode & 0777 ) != mode )
+	    ::fchmod( m_fd, mode );
+    }
+    else if ( !( mode & 0070 ) || owner.st_gid != ::getegid() || ( owner.st_mode & 0007 ) )
+    {
+	::close( m_fd );
+	throw ers::PermissionDenied( ERS_HERE, m_name.c_str(), owner.st_mode & 0777 );
+    }
+
+    // serialize layout initialization with other processes that may open the same object
+    ::flock( m_fd, LOCK_EX );
+
+    struct stat st;
+    bool initialized = !::fstat( m_fd, &st ) && st.st_size > (off_t)HeaderSize;
+    if ( initialized )
+    {
+	struct { char magic[8]; uint32_t slot_size; uint32_t version; uint64_t slots_number; } h;
+	initialized = ::pread( m_fd, &h, sizeof( h ), 0 ) == sizeof( h )
+		&& !::memcmp( h.magic, Magic, sizeof( Magic ) )
+		&& h.version == Version
+		&& (off_t)( HeaderSize + h.slot_size * h.slots_number ) == st.st_size;
+	m_slot_size = h.slot_size;
+	m_slots_number = h.slots_number;
+    }
+
+    if ( !initialized )
+    {
+	m_slot_size = ( std::max( slot_size, MinSlotSize ) + 63 ) & ~(size_t)63;
+	m_slots_number = 2;
+	while ( HeaderSize + m_slot_size * m_slots_number * 2 <= size )
+	    m_slots_number *= 2;
+    }
+    m_size = HeaderSize + m_slot_size * m_slots_number;
+
+    if ( !initialized && ( ::ftruncate( m_fd, 0 ) || ::ftruncate( m_fd, m_size ) ) )
+    {
+	::close( m_fd );
+	throw ers::CantOpenFile( ERS_HERE, m_name.c_str() );
+    }
+
+    m_address = ::mmap( 0, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0 );
+    if ( m_address == MAP_FAILED )
+    {
+	::close( m_fd );
+	throw ers::CantOpenFile( ERS_HERE, m_name.c_str() );
+    }
+    m_header = static_cast<Header *>( m_address );
+
+    if ( !initialized )
+    {
+	for ( size_t i = 0; i < m_slots_number; ++i )
+	    slot( i ).sequence.store( i, std::memory_order_relaxed );
+	m_header->slot_size = m_slot_size;
+	m_header->version = Version;
+	m_header->slots_number = m_slots_number;
+	::memcpy( m_header->magic, Magic, sizeof( Magic ) );
+    }
+
+    ::flock( m_fd, LOCK_UN );
+
+    if ( consumer )
+    {
+	// the open file description lock is released automatically if the consumer dies
+	struct flock lock;
+	::memset( &lock, 0, sizeof( lock ) );
+	lock.l_type = F_WRLCK;
+	lock.l_whence = SEEK_SET;
+	lock.l_len = 1;
+	if ( ::fcntl( m_fd, F_OFD_SETLK, &lock ) )
+	{
+	    ::munmap( m_address, m_size );
+	    ::close( m_fd );
+	    throw ers::CantOpenFile( ERS_HERE, m_name.c_str() );
+	}
+    }
+}
+
+ers::SharedMemoryQueue::~SharedMemoryQueue()
+{
+    ::munmap( m_address, m_size );
+    ::close( m_fd );
+}
+
+ers::SharedMemoryQueue::Slot &
+ers::SharedMemoryQueue::slot( uint64_t position ) const
+{
+    char * slots = static_cast<char *>( m_address ) + HeaderSize;
+    return *reinterpret_cast<Slot *>( slots + ( position & ( m_slots_number - 1 ) ) * m_slot_size );
+}
+
+uint64_t
+ers::SharedMemoryQueue::dropped() const
+{
+    return m_header->dropped.load( std::memory_order_relaxed );
+}
+
+bool
+ers::SharedMemoryQueue::push( const Issue & issue )
+{
+    const size_t capacity = m_slot_size - offsetof( Slot, data );
+
+    dunedaq::ersschema::IssueChain chain;
+    to_schema( issue, chain );
+
+    // the causes are dropped first and then the message is truncated if the chain is too long
+    size_t size = chain.ByteSizeLong();
+    if ( size > capacity && chain.causes_size() )
+    {
+	chain.clear_causes();
+	size = chain.ByteSizeLong();
+    }
+    if ( size > capacity )
+    {
+	std::string & message = *chain.mutable_final()->mutable_message();
+	message.resize( message.size() - std::min( message.size(), size - capacity ) );
+	size = chain.ByteSizeLong();
+    }
+
+    uint64_t position = m_header->tail.load( std::memory_order_relaxed );
+    Slot * s = 0;
+    while ( size <= capacity )
+    {
+	s = &slot( position );
+	int64_t diff = s->sequence.load( std::memory_order_acquire ) - position;
+	if ( diff == 0 )
+	{
+	    if ( m_header->tail.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) )
+		break;
+	}
+	else if ( diff < 0 )
+	{
+	    s = 0;	// the queue is full
+	    break;
+	}
+	else
+	{
+	    position = m_header->tail.load( std::memory_order_relaxed );
+	}
+    }
+
+    if ( !s || size > capacity )
+    {
+	m_header->dropped.fetch_add( 1, std::memory_order_relaxed );
+	return false;
+    }
+
+    chain.SerializeWithCachedSizesToArray( reinterpret_cast<uint8_t *>( s->data ) );
+    s->length = size;
+
+    // the consumer may have given up on this slot if it took too long to fill it,
+    // in which case the issue has been already counted as dropped
+    uint64_t expected = position;
+    if ( !s->sequence.compare_exchange_strong( expected, position + 1, std::memory_order_release ) )
+    {
+	return false;
+    }
+
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    if ( m_header->waiting.load( std::memory_order_relaxed ) )
+    {
+	m_header->signal.fetch_add( 1, std::memory_order_relaxed );
+	futex_wake( m_header->signal );
+    }
+    return true;
+}
+
+std::unique_ptr<ers::Issue>
+ers::SharedMemoryQueue::pop( std::chrono::milliseconds timeout )
+{
+    const size_t capacity = m_slot_size - offsetof( Slot, data );
+    bool waited = false;
+
+    while ( true )
+    {
+	uint64_t position = m_header->head.load( std::memory_order_relaxed );
+	Slot & s = slot( position );
+	uint64_t sequence = s.sequence.load( std::memory_order_acquire );
+
+	if ( sequence == position + 1 )
+	{
+	    dunedaq::ersschema::IssueChain chain;
+	    bool valid = chain.ParseFromArray( s.data, std::min<size_t>( s.length, capacity ) );
+
+	    s.sequence.store( position + m_slots_number, std::memory_order_release );
+	    m_header->head.store( position + 1, std::memory_order_relaxed );
+
+	    if ( valid )
+		return from_schema( chain );
+	    continue;
+	}
+
+	if ( m_header->tail.load( std::memory_order_relaxed ) > position )
+	{
+	    // the slot has been reserved by a producer, which may have died
+	    auto now = std::chrono::steady_clock::now();
+	    if ( m_stuck_position != position + 1 )
+	    {
+		m_stuck_position = position + 1;
+		m_stuck_since = now;
+	    }
+	    else if ( now - m_stuck_since > StuckTimeout )
+	    {
+		uint64_t expected = position;
+		if ( s.sequence.compare_exchange_strong( expected, position + m_slots_number ) )
+		{
+		    m_header->head.store( position + 1, std::memory_order_relaxed );
+		    m_header->dropped.fetch_add( 1, std::memory_order_relaxed );
+		}
+		continue;
+	    }
+	}
+
+	if ( waited )
+	    return std::unique_ptr<Issue>();
+
+	wait( timeout );
+	waited = true;
+    }
+}
+
+void
+ers::SharedMemoryQueue::wait( std::chrono::milliseconds timeout )
+{
+    uint32_t signal = m_header->signal.load( std::memory_order_relaxed );
+    m_header->waiting.store( 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+
+    uint64_t position = m_header->head.load( std::memory_order_relaxed );
+    if ( slot( position ).sequence.load( std::memory_order_acquire ) != position + 1 )
+	futex_wait( m_header->signal, signal, timeout );
+
+    m_header->waiting.store( 0, std::memory_order_relaxed );
+}
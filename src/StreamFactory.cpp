@@ -35,6 +35,28 @@ ers::StreamFactory::instance()
     return *instance;
 } // instance
 
+/** Returns the creator of the given stream. If it is not registered yet
+  * the plugin implementing this stream is loaded.
+  * \return the creator or null if the stream is not found
+  */
+template <class Map>
+typename Map::mapped_type
+ers::StreamFactory::find_creator( const Map & factories, const std::string & name ) const
+{
+    do
+    {
+	std::scoped_lock lock( m_mutex );
+	typename Map::const_iterator it = factories.find( name );
+	if ( it != factories.end() )
+	{
+	    return it->second;
+	}
+    }
+    while ( m_plugin_manager.load( name ) );
+
+    return 0;
+}
+
 /** Builds a stream from a textual key 
   * The key should have the format \c stream_name[(stream_parameters)]
   * For some streams parameters can be ommitted. 
@@ -52,18 +74,18 @@ ers::StreamFactory::create_out_stream( const std::string & format ) const
     if ( start != std::string::npos )
     {
 	key = format.substr( 0, start );
-	std::string::size_type end = format.find( ')', start );
+	std::string::size_type end = format.rfind( ')' );
         if ( end != std::string::npos )
             param = format.substr( start + 1, end - start - 1 );
     }    	
 
-    OutFunctionMap::const_iterator it = m_out_factories.find( key );
+    OutputStreamCreator creator = find_creator( m_out_factories, key );
     
-    if( it != m_out_factories.end() )
+    if( creator )
     {
 	try
         {
-            return it->second( param );
+            return creator( param );
         }
         catch( ers::Issue & issue )
         {
@@ -106,13 +128,13 @@ ers::StreamFactory::create_in_stream(
 	const std::string & stream, 
 	const std::initializer_list<std::string> & params ) const
 {
-    InFunctionMap::const_iterator it = m_in_factories.find( stream );
+    InputStreamCreator creator = find_creator( m_in_factories, stream );
     
-    if( it != m_in_factories.end() )
+    if( creator )
     {
 	try
         {
-            return it->second( params );
+            return creator( params );
         }
         catch( ers::Issue & issue )
         {
@@ -136,6 +158,7 @@ ers::StreamFactory::create_in_stream(
 void
 ers::StreamFactory::register_in_stream( const std::string & name, InputStreamCreator callback )
 {
+    std::scoped_lock lock( m_mutex );
     m_in_factories[name] = callback;
 }
 
@@ -152,12 +175,14 @@ ers::StreamFactory::register_in_stream( const std::string & name, InputStreamCre
 void
 ers::StreamFactory::register_out_stream( const std::string & name, OutputStreamCreator callback )
 {
+    std::scoped_lock lock( m_mutex );
     m_out_factories[name] = callback;
 }
 
 std::ostream & 
 ers::operator<<( std::ostream & out, const ers::StreamFactory & sf )
 {
+    std::scoped_lock lock( sf.m_mutex );
     StreamFactory::OutFunctionMap::const_iterator oit = sf.m_out_factories.begin();
     for( ; oit != sf.m_out_factories.end(); ++oit )
     {	
@@ -9,7 +9,11 @@
  */
 
 #include <assert.h>
+
+#include <algorithm>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 #include <ers/Issue.hpp>
 #include <ers/InputStream.hpp>
@@ -21,7 +25,7 @@
 #include <ers/ers.hpp>
 #include <ers/internal/macro.hpp>
 #include <ers/internal/Util.hpp>
-#include <ers/internal/PluginManager.hpp>
+#include <ers/internal/FlightRecorder.hpp>
 #include <ers/internal/NullStream.hpp>
 #include <ers/internal/SingletonCreator.hpp>
 
@@ -127,15 +131,40 @@ namespace ers
                 return ;
             }
 
-	    if ( m_manager.m_out_streams[s].get() == this ) {
-		m_manager.m_out_streams[s] =
-		    std::shared_ptr<OutputStream>( m_manager.setup_stream( s ) );
-	    }
-	    m_manager.report_issue( s, issue );
+	    setup( s );
+	    // the issue has been already recorded by the caller, which has also set its severity
+	    // together with the debug rank, so it is passed to the stream as it is
+	    m_manager.m_out_streams[s]->write( issue );
             m_in_progress = false;
 	  }
           
+	  // Creates the streams for the given severity unless they have been already created,
+	  // returns false if the stream configuration has errors
+	  bool initialize( ers::severity s )
+	  {
+	    std::scoped_lock lock( m_mutex );
+
+	    if ( m_in_progress ) {
+		return true;
+	    }
+
+	    m_in_progress = true;
+	    bool valid = setup( s );
+	    m_in_progress = false;
+	    return valid;
+	  }
+          
         private:
+	  bool setup( ers::severity s )
+	  {
+	    bool valid = true;
+	    if ( m_manager.m_out_streams[s].get() == this ) {
+		m_manager.m_out_streams[s] =
+		    std::shared_ptr<OutputStream>( m_manager.setup_stream( s, valid ) );
+	    }
+	    return valid;
+	  }
+
 	  std::recursive_mutex   m_mutex;
 	  StreamManager &	 m_manager; 
           bool			 m_in_progress;
@@ -174,6 +203,44 @@ ers::StreamManager::StreamManager()
 ers::StreamManager::~StreamManager()
 { ; }
 
+/** Creates the streams for all severities, which otherwise would be created when the first issue
+  * of the respective severity is reported.
+  * \param parallel if true the streams for different severities are created by separate threads
+  * \return false if the configuration of any stream has errors, in which case the problems have been
+  *		printed to the standard error stream and the default configuration is used for the respective severity
+  */
+bool
+ers::StreamManager::initialize( bool parallel )
+{
+    bool valid[ers::Fatal + 1];
+    auto init = [this, &valid]( short s )
+    {
+	valid[s] = static_cast<StreamInitializer*>( m_init_streams[s].get() )->initialize( (ers::severity)s );
+    };
+
+    if ( parallel )
+    {
+	std::vector<std::thread> threads;
+	for( short ss = ers::Debug; ss <= ers::Fatal; ++ss )
+	{
+	    threads.emplace_back( init, ss );
+	}
+	for( auto & t : threads )
+	{
+	    t.join();
+	}
+    }
+    else
+    {
+	for( short ss = ers::Debug; ss <= ers::Fatal; ++ss )
+	{
+	    init( ss );
+	}
+    }
+
+    return std::all_of( std::begin( valid ), std::end( valid ), []( bool v ) { return v; } );
+}
+
 void
 ers::StreamManager::add_output_stream( ers::severity severity, ers::OutputStream * new_stream )
 {    
@@ -232,7 +299,7 @@ ers::StreamManager::remove_receiver( ers::IssueReceiver * receiver )
 }
 
 ers::OutputStream * 
-ers::StreamManager::setup_stream( ers::severity severity )
+ers::StreamManager::setup_stream( ers::severity severity, bool & valid )
 {    
     std::string config = get_stream_description( severity );
     std::vector<std::string> streams;
@@ -244,17 +311,20 @@ ers::StreamManager::setup_stream( ers::severity severity )
     {
 	ERS_INTERNAL_ERROR(	"Configuration for the \"" << severity << "\" stream is invalid. "
         			"Default configuration will be used." );
+	valid = false;
     }
 
-    ers::OutputStream * main = setup_stream( streams );
+    ers::OutputStream * main = setup_stream( streams, valid );
     
     if ( !main )
     {
+	valid = false;
 	std::vector<std::string> default_streams;
 	try
 	{
 	    parse_stream_definition( DefaultOutputStreams[severity], default_streams );
-	    main = setup_stream( default_streams );
+	    bool default_valid = true;
+	    main = setup_stream( default_streams, default_valid );
         }
 	catch ( ers::BadConfiguration & ex )
 	{
@@ -266,7 +336,7 @@ ers::StreamManager::setup_stream( ers::severity severity )
 }
 
 ers::OutputStream * 
-ers::StreamManager::setup_stream( const std::vector<std::string> & streams )
+ers::StreamManager::setup_stream( const std::vector<std::string> & streams, bool & valid )
 {    
     size_t cnt = 0;
     ers::OutputStream * main = 0;
@@ -275,6 +345,7 @@ ers::StreamManager::setup_stream( const std::vector<std::string> & streams )
 	main = ers::StreamFactory::instance().create_out_stream( streams[cnt] );
         if ( main )
             break;
+	valid = false;
     }
     
     if ( !main )
@@ -292,6 +363,10 @@ ers::StreamManager::setup_stream( const std::vector<std::string> & streams )
 	    head->chained( chained );
 	    head = chained;
         }
+	else
+	{
+	    valid = false;
+	}
     }
         
     return main;
@@ -305,6 +380,7 @@ void
 ers::StreamManager::report_issue( ers::severity type, const Issue & issue )
 {
     ers::severity old_severity = issue.set_severity( type );
+    FlightRecorder::record( issue );
     m_out_streams[type]->write( issue );
     issue.set_severity( old_severity );
 } // error
@@ -325,12 +401,19 @@ ers::StreamManager::error( const Issue & issue )
 void
 ers::StreamManager::debug( const Issue & issue, int level )
 {
-    if ( Configuration::instance().debug_level() >= level )
+    if ( Configuration::instance().debug_level( issue.context() ) >= level )
     {
 	ers::severity old_severity = issue.set_severity( ers::Severity( ers::Debug, level ) );
+	FlightRecorder::record( issue );
 	m_out_streams[ers::Debug]->write( issue );
 	issue.set_severity( old_severity );
     }
+    else if ( FlightRecorder::records_debug( level ) )
+    {
+	ers::severity old_severity = issue.set_severity( ers::Severity( ers::Debug, level ) );
+	FlightRecorder::record( issue );
+	issue.set_severity( old_severity );
+    }
 }
 
 /** Sends an Issue to the fatal error stream 
@@ -1,4 +1,6 @@
+#include <ctype.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include <ers/internal/Util.hpp>
 #include <ers/internal/macro.hpp>
@@ -23,6 +25,30 @@ ers::tokenize(	const std::string & text,
     while( start_p != std::string::npos );
 }
 
+void
+ers::tokenize_trimmed(	const std::string & text,
+			const std::string & separators,
+			std::vector<std::string> & result )
+{
+    static const char * const spaces = " \t";
+
+    size_t first = result.size();
+    tokenize( text, separators, result );
+    for ( size_t i = first; i < result.size(); ++i )
+    {
+	std::string & token = result[i];
+	std::string::size_type start_p = token.find_first_not_of( spaces );
+	if ( start_p == std::string::npos )
+	{
+	    token.clear();
+	}
+	else
+	{
+	    token = token.substr( start_p, token.find_last_not_of( spaces ) - start_p + 1 );
+	}
+    }
+}
+
 int
 ers::read_from_environment( const char * name, int default_value )
 {
@@ -48,3 +74,50 @@ ers::read_from_environment( const char * name, const char * default_value )
 
 
 
+
+/** Converts a string, which may have one of the "k", "M" or "G" suffixes, into a number of bytes
+  */
+size_t
+ers::parse_size( const std::string & text, size_t default_value )
+{
+    char * end;
+    unsigned long long value = ::strtoull( text.c_str(), &end, 10 );
+    if ( end == text.c_str() )
+    {
+	return default_value;
+    }
+
+    switch ( *end )
+    {
+	case 'g': case 'G':	value <<= 10; [[fallthrough]];
+	case 'm': case 'M':	value <<= 10; [[fallthrough]];
+	case 'k': case 'K':	value <<= 10; break;
+	default:		break;
+    }
+    return value;
+}
+
+bool
+ers::try_parse_size( const std::string & text, size_t & value )
+{
+    if ( text.empty() || !::isdigit( text[0] ) )
+    {
+	return false;
+    }
+
+    char * end;
+    unsigned long long v = ::strtoull( text.c_str(), &end, 10 );
+    switch ( *end )
+    {
+	case 'g': case 'G':	v <<= 10; [[fallthrough]];
+	case 'm': case 'M':	v <<= 10; [[fallthrough]];
+	case 'k': case 'K':	v <<= 10; ++end; break;
+	default:		break;
+    }
+    if ( *end )
+    {
+	return false;
+    }
+    value = v;
+    return true;
+}
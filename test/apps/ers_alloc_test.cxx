@@ -0,0 +1,155 @@
+/*
+ *  ers_alloc_test.cxx
+ *  Test
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file ers_alloc_test.cxx
+ * Counts heap allocations made by the reporting thread for typical reporting paths and fails
+ * if any of them exceeds its budget. The allocations are counted by the malloc family functions
+ * defined here, which replace the ones of the C library for the whole process.
+ */
+
+#include "ers/ers.hpp"
+
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+  void* __libc_malloc(size_t size);
+  void* __libc_calloc(size_t n, size_t size);
+  void* __libc_realloc(void* p, size_t size);
+  void __libc_free(void* p);
+}
+
+namespace {
+// Allocations made by the current thread
+thread_local size_t allocations = 0;
+}
+
+extern "C"
+{
+  void* malloc(size_t size)
+  {
+    ++allocations;
+    return __libc_malloc(size);
+  }
+
+  void* calloc(size_t n, size_t size)
+  {
+    ++allocations;
+    return __libc_calloc(n, size);
+  }
+
+  void* realloc(void* p, size_t size)
+  {
+    ++allocations;
+    return __libc_realloc(p, size);
+  }
+
+  void free(void* p) { __libc_free(p); }
+}
+
+ERS_DECLARE_ISSUE(ers_alloc_test, TestIssue, "Allocation test issue " << index, ((int)index))
+
+namespace {
+
+const int WarmUp = 1000;
+const int Iterations = 1000;
+// Allowance for the scenarios which allocate memory: the number of allocations made by the standard library,
+// e.g. by the string streams, depends on the toolchain. The paths which must not allocate have exact budgets.
+const double Margin = 2;
+
+struct Scenario
+{
+  std::string name;
+  double budget; // maximum average number of allocations per report
+  std::function<void()> report;
+};
+
+// The streams configuration must be set before ERS reads it
+void
+configure()
+{
+  ::setenv("DUNEDAQ_ERS_DEBUG_LEVEL", "0", 1);
+  ::setenv("DUNEDAQ_ERS_DEBUG", "lstdout", 1);
+  ::setenv("DUNEDAQ_ERS_LOG", "filter(!ers_alloc_test),lstdout", 1);
+  ::setenv("DUNEDAQ_ERS_INFO", "throttle(0,1000000),null", 1);
+  ::setenv("DUNEDAQ_ERS_WARNING", "rfilter(!ers_alloc_test),lstderr", 1);
+  ::setenv("DUNEDAQ_ERS_ERROR", "null", 1);
+  ::setenv("DUNEDAQ_ERS_FATAL", "lfile(/dev/null)", 1);
+}
+
+} // namespace
+
+int
+main(int, char**)
+{
+  configure();
+  ers::initialize(false);
+
+  ers_alloc_test::TestIssue issue(ERS_HERE, 1);
+  issue.add_qualifier("ers_alloc_test");
+  ers::StreamManager& manager = ers::StreamManager::instance();
+
+  std::vector<Scenario> scenarios = {
+    { "debug/disabled site",
+      0,
+      [] {
+        if (ERS_DEBUG_ENABLED(5))
+          ers::debug(ers_alloc_test::TestIssue(ERS_HERE, 2), 5);
+      } },
+    { "debug/suppressed level", 0, [&] { ers::debug(issue, 5); } },
+    { "log/filter rejected", 0, [&] { manager.report_issue(ers::Log, issue); } },
+    // the throttle clones the issue when it reports the number of suppressed ones
+    { "info/throttle suppressed", 0.1, [&] { manager.report_issue(ers::Information, issue); } },
+    { "warning/rfilter rejected", 0, [&] { manager.report_issue(ers::Warning, issue); } },
+    { "error/null stream", 0, [&] { manager.report_issue(ers::Error, issue); } },
+    // the time string and the string stream formatting the position with its result
+    { "fatal/file stream", 3 + Margin, [&] { manager.report_issue(ers::Fatal, issue); } },
+    // the context copy, the qualifiers vector, the parameter node, the string stream formatting
+    // the message with its result and the concatenation of the message with the inherited one
+    { "issue/construct", 6 + Margin, [] { ers_alloc_test::TestIssue i(ERS_HERE, 3); } },
+    // the issue, the context copy, the message, the qualifiers vector and the parameter node
+    { "issue/clone", 5 + Margin, [&] { std::unique_ptr<ers::Issue> i(issue.clone()); } },
+  };
+
+  bool failed = false;
+  auto check = [&failed](const Scenario& s) {
+    for (int i = 0; i < WarmUp; ++i)
+      s.report();
+
+    size_t before = allocations;
+    for (int i = 0; i < Iterations; ++i)
+      s.report();
+    double average = double(allocations - before) / Iterations;
+
+    bool ok = average <= s.budget;
+    failed = failed || !ok;
+    std::cout << std::left << std::setw(32) << s.name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << average << " allocations per issue, budget " << std::setw(6) << s.budget
+              << (ok ? "" : "   FAILED") << std::endl;
+  };
+
+  for (const Scenario& s : scenarios)
+    check(s);
+
+  // The issue is cloned and passed to the catcher thread, which adds the queue node to the allocations of the clone
+  {
+    std::unique_ptr<ers::IssueCatcherHandler> handler(ers::set_issue_catcher([](const ers::Issue&) {}));
+    check({ "local/catcher hand-off", 6 + Margin, [&] {
+             ers::error(issue);
+             ers::LocalStream::instance().wait_until_drained();
+           } });
+  }
+
+  return failed ? 1 : 0;
+}
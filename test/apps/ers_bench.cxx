@@ -0,0 +1,327 @@
+/*
+ *  ers_bench.cxx
+ *  Test
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file ers_bench.cxx
+ * Microbenchmarks for the ERS hot paths. The results are printed to the standard output
+ * and written to a JSON file, which can be compared between releases.
+ */
+
+#include "ers/OutputStream.hpp"
+#include "ers/Schema.hpp"
+#include "ers/StandardStreamOutput.hpp"
+#include "ers/StreamFactory.hpp"
+#include "ers/ers.hpp"
+
+#include <boost/asio/ip/host_name.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+ERS_DECLARE_ISSUE(ers_bench, Issue0, "Benchmark issue", ERS_EMPTY)
+
+ERS_DECLARE_ISSUE(ers_bench, Issue1, "Benchmark issue " << index, ((int)index))
+
+ERS_DECLARE_ISSUE(ers_bench,
+                  Issue5,
+                  "Benchmark issue " << index << " from \"" << source << "\" has value " << value << " of " << limit
+                                     << " (" << unit << ")",
+                  ((int)index)((std::string)source)((double)value)((long)limit)((std::string)unit))
+
+namespace {
+
+using steady_clock = std::chrono::steady_clock;
+
+template<class T>
+inline void
+do_not_optimize(const T& value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Discards everything, but lets the stream do all the formatting
+class NullBuffer : public std::streambuf
+{
+protected:
+  int overflow(int c) override { return c; }
+  std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+struct Benchmark
+{
+  std::string name;
+  std::function<void(size_t)> body; // runs the given number of iterations
+  std::function<void()> finish = {}; // completes the work started by the body, is measured as well
+};
+
+struct Result
+{
+  std::string name;
+  size_t iterations;
+  double median;
+  double min;
+};
+
+double
+measure(const Benchmark& b, size_t iterations)
+{
+  steady_clock::time_point start = steady_clock::now();
+  b.body(iterations);
+  if (b.finish)
+    b.finish();
+  return std::chrono::duration<double, std::nano>(steady_clock::now() - start).count() / iterations;
+}
+
+Result
+run(const Benchmark& b, double seconds, int repetitions)
+{
+  // the number of iterations is calibrated so that each repetition takes the given time
+  size_t iterations = 1;
+  double ns = measure(b, iterations);
+  while (ns * iterations < seconds * 1e9 / 10 && iterations < (1ul << 30)) {
+    iterations *= 10;
+    ns = measure(b, iterations);
+  }
+  iterations = std::max<size_t>(1, seconds * 1e9 / ns);
+
+  std::vector<double> results;
+  for (int i = 0; i < repetitions; ++i) {
+    results.push_back(measure(b, iterations));
+  }
+  std::sort(results.begin(), results.end());
+  return Result{ b.name, iterations, results[results.size() / 2], results.front() };
+}
+
+std::shared_ptr<ers::OutputStream>
+create_stream(const std::string& format)
+{
+  std::shared_ptr<ers::OutputStream> stream(ers::StreamFactory::instance().create_out_stream(format));
+  if (!stream) {
+    throw std::runtime_error("can not create \"" + format + "\" stream");
+  }
+  return stream;
+}
+
+Benchmark
+stream_benchmark(const std::string& name, const std::string& format, const ers::Issue& issue)
+{
+  std::shared_ptr<ers::OutputStream> stream = create_stream(format);
+  return { name, [stream, &issue](size_t n) {
+            for (size_t i = 0; i < n; ++i)
+              stream->write(issue);
+          } };
+}
+
+std::vector<Benchmark>
+make_benchmarks(NullBuffer& buffer, std::vector<std::unique_ptr<ers::Issue>>& issues)
+{
+  std::vector<Benchmark> benchmarks;
+
+  // ERS_HERE captures the stack as well unless ERS_NO_DEBUG is defined, so both cases are constructed explicitly
+  benchmarks.push_back({ "context/without_stack", [](size_t n) {
+                          for (size_t i = 0; i < n; ++i) {
+                            ers::LocalContext c(ERS_PACKAGE, __FILE__, __LINE__, __PRETTY_FUNCTION__, false);
+                            do_not_optimize(c);
+                          }
+                        } });
+
+  benchmarks.push_back({ "context/with_stack", [](size_t n) {
+                          for (size_t i = 0; i < n; ++i) {
+                            ers::LocalContext c(ERS_PACKAGE, __FILE__, __LINE__, __PRETTY_FUNCTION__, true);
+                            do_not_optimize(c);
+                          }
+                        } });
+
+  benchmarks.push_back({ "issue/construct/0", [](size_t n) {
+                          for (size_t i = 0; i < n; ++i) {
+                            ers_bench::Issue0 issue(ERS_HERE);
+                            do_not_optimize(issue);
+                          }
+                        } });
+
+  benchmarks.push_back({ "issue/construct/1", [](size_t n) {
+                          for (size_t i = 0; i < n; ++i) {
+                            ers_bench::Issue1 issue(ERS_HERE, i);
+                            do_not_optimize(issue);
+                          }
+                        } });
+
+  benchmarks.push_back({ "issue/construct/5", [](size_t n) {
+                          for (size_t i = 0; i < n; ++i) {
+                            ers_bench::Issue5 issue(ERS_HERE, i, "ers_bench", 3.14, 100, "Hz");
+                            do_not_optimize(issue);
+                          }
+                        } });
+
+  issues.emplace_back(new ers_bench::Issue5(ERS_HERE, 1, "ers_bench", 3.14, 100, "Hz"));
+  issues.back()->add_qualifier("ers_bench"); // used by the filter streams
+  const ers::Issue& issue = *issues.back();
+  issues.emplace_back(new ers_bench::Issue1(ERS_HERE, 2, issue));
+  const ers::Issue& chained = *issues.back();
+
+  benchmarks.push_back({ "issue/clone", [&issue](size_t n) {
+                          for (size_t i = 0; i < n; ++i) {
+                            std::unique_ptr<ers::Issue> c(issue.clone());
+                            do_not_optimize(c);
+                          }
+                        } });
+
+  benchmarks.push_back({ "issue/clone/chained", [&chained](size_t n) {
+                          for (size_t i = 0; i < n; ++i) {
+                            std::unique_ptr<ers::Issue> c(chained.clone());
+                            do_not_optimize(c);
+                          }
+                        } });
+
+  for (int verbosity = -3; verbosity <= 4; ++verbosity) {
+    benchmarks.push_back({ "print/verbosity/" + std::to_string(verbosity), [&buffer, &issue, verbosity](size_t n) {
+                            std::ostream out(&buffer);
+                            for (size_t i = 0; i < n; ++i)
+                              ers::StandardStreamOutput::println(out, issue, verbosity);
+                          } });
+  }
+
+  benchmarks.push_back(stream_benchmark("stream/file", "file(/dev/null)", issue));
+  benchmarks.push_back(
+    stream_benchmark("stream/ffile", "ffile(/dev/null,time,severity,position,message,parameters)", issue));
+  benchmarks.push_back(stream_benchmark("stream/throttle/passed", "throttle(2000000000,30)", issue));
+  benchmarks.push_back(stream_benchmark("stream/throttle/suppressed", "throttle(0,1000000000)", issue));
+  benchmarks.push_back(stream_benchmark("stream/filter/passed", "filter(ers_bench)", issue));
+  benchmarks.push_back(stream_benchmark("stream/filter/rejected", "filter(!ers_bench)", issue));
+  benchmarks.push_back(stream_benchmark("stream/rfilter/passed", "rfilter(ers_.*)", issue));
+  benchmarks.push_back(stream_benchmark("stream/rfilter/rejected", "rfilter(!ers_.*)", issue));
+
+  benchmarks.push_back({ "schema/to_schema", [&issue](size_t n) {
+                          for (size_t i = 0; i < n; ++i) {
+                            dunedaq::ersschema::SimpleIssue s = ers::to_schema(issue);
+                            do_not_optimize(s);
+                          }
+                        } });
+
+  benchmarks.push_back({ "schema/to_schema_chain", [&chained](size_t n) {
+                          for (size_t i = 0; i < n; ++i) {
+                            dunedaq::ersschema::IssueChain s = ers::to_schema_chain(chained);
+                            do_not_optimize(s);
+                          }
+                        } });
+
+  // the issues are passed to a catcher thread running an empty catcher, the queue is drained periodically
+  // and at the end of every measurement, so all the issues are processed within the measured time
+  std::shared_ptr<ers::IssueCatcherHandler> handler(ers::set_issue_catcher([](const ers::Issue&) {}));
+  benchmarks.push_back({ "local/handoff",
+                         [handler, &issue](size_t n) {
+                           for (size_t i = 0; i < n; ++i) {
+                             ers::warning(issue);
+                             if (i % 1024 == 1023) {
+                               ers::LocalStream::instance().wait_until_drained();
+                             }
+                           }
+                         },
+                         [] { ers::LocalStream::instance().wait_until_drained(); } });
+
+  return benchmarks;
+}
+
+void
+write_json(std::ostream& out, const std::vector<Result>& results, double seconds, int repetitions)
+{
+  std::time_t now = std::time(0);
+  char time[64];
+  std::strftime(time, sizeof(time), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+  out << "{\n";
+  out << "  \"time\": \"" << time << "\",\n";
+  out << "  \"host\": \"" << boost::asio::ip::host_name() << "\",\n";
+  out << "  \"seconds\": " << seconds << ",\n";
+  out << "  \"repetitions\": " << repetitions << ",\n";
+  out << "  \"benchmarks\": [\n";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Result& r = results[i];
+    out << "    { \"name\": \"" << r.name << "\", \"iterations\": " << r.iterations << ", \"ns_per_op\": " << std::fixed
+        << std::setprecision(2) << r.median << ", \"ns_per_op_min\": " << r.min << " }"
+        << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  out << "  ]\n";
+  out << "}\n";
+}
+
+void
+print_usage()
+{
+  std::cout << "Usage: ers_bench [-h] [-o file] [-s seconds] [-r repetitions] [filter]" << std::endl;
+  std::cout << "Options/Arguments:" << std::endl;
+  std::cout << "\t-h\t\tprints this help screen." << std::endl;
+  std::cout << "\t-o file\t\twrites the results to the given JSON file, default is \"ers_bench.json\"." << std::endl;
+  std::cout << "\t-s seconds\tduration of one repetition, default is 0.1." << std::endl;
+  std::cout << "\t-r repetitions\tnumber of repetitions, the median is reported, default is 5." << std::endl;
+  std::cout << "\tfilter\t\truns only the benchmarks which names contain the given string." << std::endl;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  std::string output("ers_bench.json");
+  double seconds = 0.1;
+  int repetitions = 5;
+  std::string filter;
+
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
+      print_usage();
+      return 0;
+    } else if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+      output = argv[++i];
+    } else if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+      seconds = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+      repetitions = std::max(1, atoi(argv[++i]));
+    } else {
+      filter = argv[i];
+    }
+  }
+
+  NullBuffer buffer;
+  std::vector<std::unique_ptr<ers::Issue>> issues;
+  std::vector<Benchmark> benchmarks;
+  try {
+    benchmarks = make_benchmarks(buffer, issues);
+  } catch (std::exception& ex) {
+    std::cerr << "Benchmarks can not be created: " << ex.what() << std::endl;
+    return 1;
+  }
+
+  std::vector<Result> results;
+  for (const Benchmark& b : benchmarks) {
+    if (b.name.find(filter) == std::string::npos)
+      continue;
+
+    results.push_back(run(b, seconds, repetitions));
+    const Result& r = results.back();
+    std::cout << std::left << std::setw(36) << r.name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << r.median << " ns" << std::setw(12) << r.min << " ns (min)" << std::endl;
+  }
+
+  std::ofstream out(output);
+  if (!out) {
+    std::cerr << "Can not open \"" << output << "\" file" << std::endl;
+    return 1;
+  }
+  write_json(out, results, seconds, repetitions);
+  return 0;
+}
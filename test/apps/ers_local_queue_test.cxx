@@ -0,0 +1,246 @@
+/*
+ *  ers_local_queue_test.cxx
+ *  Test
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file ers_local_queue_test.cxx
+ * Checks the overflow policies of the bounded local stream queue. Every scenario fills the queue
+ * behind a catcher, which is blocked until the scenario releases it, and verifies the statistics
+ * and the set of issues processed by the catcher.
+ */
+
+#include "ers/ers.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+ERS_DECLARE_ISSUE(ers_local_queue_test, TestIssue, "Local queue test issue " << index, ((int)index))
+
+namespace {
+
+const size_t Capacity = 4;
+// Time given to a reporting thread or a catcher thread to reach the point where it waits
+const std::chrono::milliseconds Delay(200);
+
+bool failed = false;
+
+void
+check(const std::string& what, bool ok)
+{
+  failed = failed || !ok;
+  std::cout << (ok ? "passed" : "FAILED") << ": " << what << std::endl;
+}
+
+// All issues are reported at the same place, so they are processed in order by an ordered catcher
+void
+report(int index, ers::severity severity = ers::Error)
+{
+  ers_local_queue_test::TestIssue issue(ERS_HERE, index);
+  if (severity == ers::Error)
+    ers::LocalStream::instance().error(issue);
+  else
+    ers::LocalStream::instance().warning(issue);
+}
+
+// Catcher, which blocks all its threads until it is released
+class BlockedCatcher
+{
+public:
+  void operator()(const ers::Issue& issue)
+  {
+    std::unique_lock lock(m_mutex);
+    ++m_entered;
+    m_condition.notify_all();
+    m_condition.wait(lock, [this] { return m_released; });
+    m_processed.push_back(std::stoi(issue.parameters().at("index")));
+  }
+
+  void wait_entered(size_t threads)
+  {
+    std::unique_lock lock(m_mutex);
+    m_condition.wait(lock, [this, threads] { return m_entered >= threads; });
+  }
+
+  void release()
+  {
+    std::unique_lock lock(m_mutex);
+    m_released = true;
+    m_condition.notify_all();
+  }
+
+  std::vector<int> processed()
+  {
+    std::unique_lock lock(m_mutex);
+    return m_processed;
+  }
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  size_t m_entered = 0;
+  bool m_released = false;
+  std::vector<int> m_processed;
+};
+
+ers::IssueCatcherHandler*
+set_catcher(BlockedCatcher& catcher, unsigned int threads = 1)
+{
+  return ers::set_issue_catcher([&catcher](const ers::Issue& issue) { catcher(issue); }, threads);
+}
+
+bool
+statistics_are(uint64_t enqueued, uint64_t dropped, size_t high_water_mark, size_t pending)
+{
+  ers::LocalStreamStatistics s = ers::LocalStream::instance().statistics();
+  bool ok = s.enqueued == enqueued && s.dropped == dropped && s.high_water_mark == high_water_mark &&
+            s.pending == pending;
+  if (!ok)
+    std::cout << "enqueued " << s.enqueued << ", dropped " << s.dropped << ", high water mark "
+              << s.high_water_mark << ", pending " << s.pending << std::endl;
+  return ok;
+}
+
+// Fills the queue: the issue 0 is being processed and the issues 1 .. Capacity-1 are queued
+void
+fill(BlockedCatcher& catcher)
+{
+  report(0);
+  catcher.wait_entered(1);
+  for (size_t i = 1; i < Capacity; ++i)
+    report(i);
+}
+
+void
+test_drop_newest()
+{
+  ers::LocalStream::instance().set_queue_limit(Capacity, ers::OverflowPolicy::DropNewest);
+  BlockedCatcher catcher;
+  std::unique_ptr<ers::IssueCatcherHandler> handler(set_catcher(catcher));
+
+  fill(catcher);
+  for (int i = Capacity; i < 9; ++i)
+    report(i);
+  check("drop-newest: the new issues are dropped", statistics_are(4, 5, 4, 4));
+
+  catcher.release();
+  ers::LocalStream::instance().wait_until_drained();
+  check("drop-newest: the first issues are processed", catcher.processed() == std::vector<int>({ 0, 1, 2, 3 }));
+  check("drop-newest: the queue is drained", statistics_are(4, 5, 4, 0));
+}
+
+void
+test_drop_oldest()
+{
+  ers::LocalStream::instance().set_queue_limit(Capacity, ers::OverflowPolicy::DropOldest);
+  BlockedCatcher catcher;
+  std::unique_ptr<ers::IssueCatcherHandler> handler(set_catcher(catcher));
+
+  fill(catcher);
+  for (int i = Capacity; i < 9; ++i)
+    report(i);
+  check("drop-oldest: the queued issues are dropped", statistics_are(9, 5, 4, 4));
+
+  catcher.release();
+  ers::LocalStream::instance().wait_until_drained();
+  check("drop-oldest: the last issues are processed", catcher.processed() == std::vector<int>({ 0, 6, 7, 8 }));
+}
+
+// The issue 1 is parked by the second catcher thread because the issue 0 reported at the same place
+// is being processed, so there is no queued issue to drop and the new one is dropped instead
+void
+test_drop_oldest_busy_site()
+{
+  ers::LocalStream::instance().set_queue_limit(2, ers::OverflowPolicy::DropOldest);
+  BlockedCatcher catcher;
+  std::unique_ptr<ers::IssueCatcherHandler> handler(set_catcher(catcher, 2));
+
+  report(0);
+  catcher.wait_entered(1);
+  report(1);
+  std::this_thread::sleep_for(Delay);
+  report(2);
+  check("drop-oldest: the new issue is dropped if the queued ones are parked", statistics_are(2, 1, 2, 2));
+
+  catcher.release();
+  ers::LocalStream::instance().wait_until_drained();
+  check("drop-oldest: the parked issue is processed", catcher.processed() == std::vector<int>({ 0, 1 }));
+}
+
+void
+test_block()
+{
+  ers::LocalStream::instance().set_queue_limit(Capacity, ers::OverflowPolicy::Block);
+  BlockedCatcher catcher;
+  std::unique_ptr<ers::IssueCatcherHandler> handler(set_catcher(catcher));
+
+  fill(catcher);
+  std::atomic<bool> reported(false);
+  std::thread reporter([&reported] {
+    report(Capacity);
+    reported = true;
+  });
+
+  auto start = std::chrono::steady_clock::now();
+  bool drained = ers::LocalStream::instance().wait_until_drained(Delay);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  check("block: waiting for the full queue times out", !drained && elapsed >= Delay);
+  check("block: the reporting thread waits", !reported && statistics_are(4, 0, 4, 4));
+
+  catcher.release();
+  reporter.join();
+  check("block: the queue is drained before the timeout",
+        ers::LocalStream::instance().wait_until_drained(std::chrono::seconds(10)));
+  check("block: all issues are processed", catcher.processed() == std::vector<int>({ 0, 1, 2, 3, 4 }));
+  check("block: nothing is dropped", statistics_are(5, 0, 4, 0));
+}
+
+void
+test_drop_below_severity()
+{
+  ers::LocalStream::instance().set_queue_limit(Capacity, ers::OverflowPolicy::DropBelowSeverity, ers::Error);
+  BlockedCatcher catcher;
+  std::unique_ptr<ers::IssueCatcherHandler> handler(set_catcher(catcher));
+
+  fill(catcher);
+  report(Capacity, ers::Warning);
+  check("drop-below-severity: the warning is dropped", statistics_are(4, 1, 4, 4));
+
+  std::atomic<bool> reported(false);
+  std::thread reporter([&reported] {
+    report(Capacity + 1);
+    reported = true;
+  });
+  std::this_thread::sleep_for(Delay);
+  check("drop-below-severity: the error waits", !reported);
+
+  catcher.release();
+  reporter.join();
+  ers::LocalStream::instance().wait_until_drained();
+  check("drop-below-severity: the errors are processed", catcher.processed() == std::vector<int>({ 0, 1, 2, 3, 5 }));
+  check("drop-below-severity: only the warning is dropped", statistics_are(5, 1, 4, 0));
+}
+
+} // namespace
+
+int
+main(int, char**)
+{
+  test_drop_newest();
+  test_drop_oldest();
+  test_drop_oldest_busy_site();
+  test_block();
+  test_drop_below_severity();
+
+  ers::LocalStream::instance().set_queue_limit(0);
+  return failed ? 1 : 0;
+}
@@ -17,11 +17,14 @@ struct MyIssueReceiver : public ers::IssueReceiver
 };
 
 int
-main(int, char**)
+main(int argc, char** argv)
 {
+  // e.g. "ers_receiver shm daq-node-logs" receives issues sent by the "shm(daq-node-logs)" streams
+  const char* stream = argc > 1 ? argv[1] : "mts";
+  const char* param = argc > 2 ? argv[2] : "*";
 
   try {
-    ers::StreamManager::instance().add_receiver("mts", "*", new MyIssueReceiver);
+    ers::StreamManager::instance().add_receiver(stream, param, new MyIssueReceiver);
   } catch (ers::Issue& ex) {
     ers::fatal(ex);
     return 1;
@@ -57,6 +57,14 @@ main(int argc, char* argv[])
     cout << "failure" << endl;
   }
 
+  auto issue = ers::from_schema(reco);
+  if (issue->message() == third.message() && issue->cause() && issue->cause()->cause() &&
+      issue->cause()->cause()->message() == first.message() && issue->qualifiers() == third.qualifiers()) {
+    cout << "issue success" << endl;
+  } else {
+    cout << "issue failure" << endl;
+  }
+
   // JsonStringToMessage( json, & reco_issue);
 
   // if ( issue.name() == reco_issue.name() ) {
@@ -0,0 +1,159 @@
+/*
+ *  ers_where_test.cxx
+ *  Test
+ *
+ *  Copyright 2026 CERN. All rights reserved.
+ *
+ */
+
+/** \file ers_where_test.cxx
+ * Checks which issues pass the where stream for a set of expressions and that malformed expressions
+ * are rejected. Every expression is evaluated by a child process, which appends the where stream and
+ * a probe stream to its warning and error streams and returns the set of passed issues as the exit status.
+ */
+
+#include "ers/OutputStream.hpp"
+#include "ers/SampleIssues.hpp"
+#include "ers/StreamFactory.hpp"
+#include "ers/ers.hpp"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+ERS_DECLARE_ISSUE(ers_where_test, TestIssue, "Where test issue for link " << link, ((int)link))
+
+namespace {
+
+// Index of the issue, which is being reported
+int current = 0;
+// Bit mask of the issues, which have passed the where stream
+int passed = 0;
+
+class ProbeStream : public ers::OutputStream
+{
+public:
+  void write(const ers::Issue&) override { passed |= 1 << current; }
+};
+
+struct Report
+{
+  ers::severity severity;
+  std::shared_ptr<ers::Issue> issue;
+};
+
+std::vector<Report>
+reports()
+{
+  auto readout = std::make_shared<ers_where_test::TestIssue>(ERS_HERE, 12);
+  readout->add_qualifier("readout");
+
+  return {
+    { ers::Warning, std::make_shared<ers_where_test::TestIssue>(ERS_HERE, 3) },              // 1
+    { ers::Error, readout },                                                                 // 2
+    { ers::Error, std::make_shared<ers::CantOpenFile>(ERS_HERE, "/tmp/a.data") },            // 4
+    { ers::Warning, std::make_shared<ers::PermissionDenied>(ERS_HERE, "/tmp/b.data", 0600) }, // 8
+  };
+}
+
+// Returns the bit mask of the issues passed by the given expression or -1 if the stream can not be created
+int
+evaluate(const std::string& expression)
+{
+  pid_t pid = ::fork();
+  if (pid == 0) {
+    ers::initialize(false);
+
+    ers::StreamManager& manager = ers::StreamManager::instance();
+    for (ers::severity s : { ers::Warning, ers::Error }) {
+      ers::OutputStream* where = ers::StreamFactory::instance().create_out_stream("where(" + expression + ")");
+      if (!where)
+        ::_exit(255);
+      manager.add_output_stream(s, where);
+      manager.add_output_stream(s, new ProbeStream());
+    }
+
+    std::vector<Report> rr = reports();
+    for (current = 0; current < (int)rr.size(); ++current)
+      manager.report_issue(rr[current].severity, *rr[current].issue);
+
+    ::_exit(passed);
+  }
+
+  int status = 0;
+  if (pid < 0 || ::waitpid(pid, &status, 0) != pid || !WIFEXITED(status))
+    return -2;
+
+  return WEXITSTATUS(status) == 255 ? -1 : WEXITSTATUS(status);
+}
+
+} // namespace
+
+int
+main(int, char**)
+{
+  ::setenv("DUNEDAQ_ERS_WARNING", "null", 1);
+  ::setenv("DUNEDAQ_ERS_ERROR", "null", 1);
+
+  struct Case
+  {
+    std::string expression;
+    int expected;
+  };
+
+  std::vector<Case> cases = {
+    // comparisons
+    { "", 15 },
+    { "param.link == 3", 1 },
+    { "param.link > 4", 2 },   // numeric, as a string "12" is less than "4"
+    { "param.link != 3", 2 },  // comparisons with missing parameters are false
+    { "severity >= ERROR", 6 },
+    { "qualifier == readout", 2 },
+    { "class ~ ers::File", 12 },
+    { "class == ers::CantOpenFile", 4 },
+    { "message ~ 'Can not|allowed'", 12 },
+    // precedence of && over ||
+    { "severity == WARNING || param.link == 12 && qualifier == readout", 11 },
+    { "(severity == WARNING || param.link == 12) && qualifier == readout", 2 },
+    { "param.link == 12 && qualifier == none || class ~ ers::File", 12 },
+    { "param.link == 12 && (qualifier == none || class ~ ers::File)", 0 },
+    // negation
+    { "!class ~ ers::File", 3 },
+    { "!class ~ ers::File && severity == ERROR", 2 },
+    { "!(class ~ ers::File && severity == ERROR)", 11 },
+    { "!!(param.link == 3)", 1 },
+    // nested brackets
+    { "((class == ers::CantOpenFile || (param.mode == 384)) && !(severity >= ERROR))", 8 },
+    { "(((param.link == 3)) || ((param.link == 12) && (severity == ERROR)))", 3 },
+    // malformed expressions
+    { "param.link ==", -1 },
+    { "(severity == ERROR", -1 },
+    { "severity == ERROR)", -1 },
+    { "severity == BOGUS", -1 },
+    { "severity ~ ERROR", -1 },
+    { "link == 3", -1 },
+    { "line == first", -1 },
+    { "class < ers::File", -1 },
+    { "message == 'open", -1 },
+    { "message ~ '('", -1 },
+    { "param.link == 3 && || param.link == 12", -1 },
+    { "!", -1 },
+    { "()", -1 },
+  };
+
+  bool failed = false;
+  for (const Case& c : cases) {
+    int result = evaluate(c.expression);
+    bool ok = result == c.expected;
+    failed = failed || !ok;
+    std::cout << (ok ? "passed" : "FAILED") << ": where(" << c.expression << ") gives " << result
+              << ", expected " << c.expected << std::endl;
+  }
+
+  return failed ? 1 : 0;
+}